@@ -1,21 +1,18 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include "maze_core.h"
+#include "maze_bits.h"
+#include "maze_io.h"
+#include "ao_engine.h"
 
 #define MAX_DIMENSION 100
 
-extern char** maze;
-extern int** visited;
-extern int rows, cols;
-extern int start_row, start_col;
-
-// Enum for terrain types
-enum Terrain {
-    TERRAIN_EMPTY,
-    TERRAIN_WALL,
-    TERRAIN_GOAL,
-    TERRAIN_CRUMB
-};
+struct maze_grid maze;
+struct maze_bitmap walls;    // One bit per cell: set for 'x'
+struct maze_bitmap crumbs;   // One bit per cell: set for cells on the solution path
+int rows, cols;
+int start_row, start_col, goal_row = -1, goal_col = -1;
 
 // Function prototypes
 bool is_valid(int row, int col);
@@ -26,87 +23,79 @@ void write_ao_solution(const char* file_name);
 
 // Check if a position is valid in the maze
 bool is_valid(int row, int col) {
-    return row >= 0 && row < rows && col >= 0 && col < cols && visited[row][col] != TERRAIN_WALL;
+    return row >= 0 && row < rows && col >= 0 && col < cols && !maze_bit_test(&walls, maze_bit_index(&walls, row, col));
 }
 
 // Check if the current cell is the goal
 bool is_goal(int row, int col) {
-    return visited[row][col] == TERRAIN_GOAL;
+    return row == goal_row && col == goal_col;
 }
 
-// AO* Search Algorithm
+// AO* Search Algorithm (on a maze's AND-OR graph this is A*, see ao_engine.c)
 bool ao_star(int row, int col) {
-    if (!is_valid(row, col)) {
+    if (!is_valid(row, col) || goal_row < 0) {
         return false;
     }
-
-    if (is_goal(row, col)) {
-        return true;
-    }
-
-    // Mark as visited to avoid revisiting
-    if (visited[row][col] == TERRAIN_EMPTY) {
-        visited[row][col] = TERRAIN_CRUMB;
-    }
-
-    // Explore all AND (branching) options
-    bool left = ao_star(row, col - 1);
-    bool right = ao_star(row, col + 1);
-    bool up = ao_star(row - 1, col);
-    bool down = ao_star(row + 1, col);
-
-    // If any valid path exists, return true
-    if (left || right || up || down) {
-        visited[row][col] = TERRAIN_CRUMB;  // Mark as part of the solution
-        return true;
+    struct ao_stats stats;
+    int length = ao_search(&walls, maze_bit_index(&walls, row, col),
+                           maze_bit_index(&walls, goal_row, goal_col), &crumbs, &stats);
+    printf("AO* expanded %lld nodes and marked %lld again\n", stats.expanded, stats.remarked);
+    if (length >= 0) {
+        printf("AO* path length: %d moves\n", length);
     }
-
-    // Otherwise, backtrack
-    visited[row][col] = TERRAIN_EMPTY;
-    return false;
+    return length >= 0;
 }
 
 // Mark the AO* path in the maze
 void mark_ao_path() {
-    for (int i = 0; i < rows; i++) {
-        for (int j = 0; j < cols; j++) {
-            if (visited[i][j] == TERRAIN_CRUMB) {
-                maze[i][j] = '.';
-            }
+    int n = rows * maze.stride;
+    for (int i = 0; i < n; i++) {
+        if (maze_bit_test(&crumbs, i)) {
+            maze.cells[i] = '.';
         }
     }
 }
 
 // Write the AO* solution to a file
 void write_ao_solution(const char* file_name) {
-    FILE* file = fopen(file_name, "w");
-    if (!file) {
-        printf("Error: Cannot open file %s.\n", file_name);
+    if (maze_write_grid(&maze, file_name, 0) < 0) {
         exit(EXIT_FAILURE);
     }
+}
 
-    for (int i = 0; i < rows; i++) {
-        for (int j = 0; j < cols; j++) {
-            fprintf(file, "%c", maze[i][j]);
-        }
-        fprintf(file, "\n");
+// Read the maze from a file (text or .mzb) into the grid
+void read_maze(const char* file_name) {
+    struct maze_file file;
+    if (maze_file_open(&file, file_name) < 0) {
+        exit(EXIT_FAILURE);
     }
+    rows = file.rows;
+    cols = file.cols;
+    start_row = file.start_row;
+    start_col = file.start_col;
+    goal_row = file.goal_row;
+    goal_col = file.goal_col;
+    maze_file_to_grid(&file, &maze);
+    maze_file_close(&file);
+}
 
-    fclose(file);
+// Build the wall and crumb bitmaps from the grid
+void initialize_visited() {
+    maze_bitmap_from_grid(&walls, &maze, 'x');
+    maze_bitmap_alloc(&crumbs, rows, cols);
 }
 
-void read_maze(const char* file_name);
-void initialize_visited();
-void free_memory();
-bool ao_star(int row, int col);
-void mark_ao_path();
-void write_ao_solution(const char* file_name);
+void free_memory() {
+    maze_grid_free(&maze);
+    maze_bitmap_free(&walls);
+    maze_bitmap_free(&crumbs);
+}
 
-int main() {
+int main(int argc, char* argv[]) {
     // Read the maze from the file
-    read_maze("maze.txt");
+    read_maze(argc > 1 ? argv[1] : "maze.txt");
 
-    // Initialize visited matrix
+    // Initialize the wall and crumb bitmaps
     initialize_visited();
 
     // Perform AO* search to solve the maze
@@ -2,6 +2,19 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <limits.h>
+#include "maze_core.h"
+#include "maze_bits.h"
+#include "maze_io.h"
+#include "open_list.h"
+#include "heuristic.h"
+#include "search_stats.h"
+
+// Open list used by aStarSearch, selectable on the command line ("heap" or "bucket")
+enum OpenListKind openListKind = OPEN_LIST_HEAP;
+
+// Heuristic, selectable on the command line ("manhattan", "zero" or "alt")
+enum HeuristicKind heuristicKind = HEURISTIC_DEFAULT;
+const struct Landmarks *heuristicLandmarks = NULL;
 
 // Structure to represent a cell in the grid
 struct Cell {
@@ -15,8 +28,8 @@ bool isValid(int row, int col, int numRows, int numCols) {
 }
 
 // Function to check if a given cell is blocked or not
-bool isUnblocked(int **grid, int row, int col) {
-    return grid[row][col] == 0;
+bool isUnblocked(const struct maze_bitmap *grid, int row, int col) {
+    return !maze_bit_test(grid, maze_bit_index(grid, row, col));
 }
 
 // Function to check if the destination cell has been reached
@@ -24,147 +37,140 @@ bool isDestination(int row, int col, struct Cell dest) {
     return (row == dest.row && col == dest.col);
 }
 
-// Function to calculate the heuristic value (Euclidean distance) from the current cell to the destination cell
-int calculateHValue(int row, int col, struct Cell dest) {
-    return ((row - dest.row) * (row - dest.row)) + ((col - dest.col) * (col - dest.col));
-}
-
 // Function to trace the path from the start cell to the destination cell
-void tracePath(int**grid, struct Cell **cellDetails, struct Cell dest, int numRows, int numCols, struct Cell start) {
+void tracePath(const struct maze_bitmap *grid, struct Cell *cellDetails, struct Cell dest, struct Cell start) {
     // printf("\nThe path is:\n");
-    FILE *fp2;
-    fp2 = fopen("sol.txt", "w");
     int row = dest.row;
     int col = dest.col;
+    int idx = maze_bit_index(grid, row, col);
 
-    while (!(cellDetails[row][col].row == row && cellDetails[row][col].col == col)) {
-        grid[row][col] = 2;
-        int temp_row = cellDetails[row][col].row;
-        int temp_col = cellDetails[row][col].col;
-        row = temp_row;
-        col = temp_col;
+    // One bit per cell on the path
+    struct maze_bitmap path;
+    maze_bitmap_alloc(&path, grid->rows, grid->cols);
+
+    while (!(cellDetails[idx].row == row && cellDetails[idx].col == col)) {
+        maze_bit_set(&path, idx);
+        row = cellDetails[idx].row;
+        col = cellDetails[idx].col;
+        idx = maze_bit_index(grid, row, col);
     }
-    grid[row][col] = 2;
+    maze_bit_set(&path, idx);
     
-    for (int i = 0; i < numRows; i++) {
-        for (int j = 0; j < numCols; j++) {
-            if (i == start.row && j == start.col)
-            {
-                fprintf(fp2, "%c", 's');
+    // Whole rows are rendered from the bitmaps and written through one buffer
+    struct maze_writer writer;
+    if (maze_writer_open(&writer, "sol.txt") == 0) {
+        for (int i = 0; i < grid->rows; i++) {
+            char *line = maze_writer_reserve(&writer, grid->cols + 1);
+            maze_render_row(line, grid, &path, i);
+            if (i == start.row) {
+                line[start.col] = 's';
             }
-            else if (i == dest.row && j == dest.col)
-            {
-                fprintf(fp2, "%c", 'g');
+            if (i == dest.row) {
+                line[dest.col] = 'g';
             }
-            else if(grid[i][j] == 0){
-				fprintf(fp2, "%c", ' ');
-			}
-            else if(grid[i][j] == 1){
-				fprintf(fp2, "%c", 'x');
-			}
-            else if(grid[i][j] == 2){
-				fprintf(fp2, "%c", '.');
-			}
+            line[grid->cols] = '\n';
         }
-        fprintf(fp2, "%c", '\n');
+        maze_writer_close(&writer);
     }
-
+    maze_bitmap_free(&path);
 }
 
 // Function to implement the A* algorithm
 // Function to implement the A* algorithm without diagonal movement
-void aStarSearch(int **grid, int numRows, int numCols, struct Cell start, struct Cell dest) {
-    // Array to hold details of each cell
-    struct Cell **cellDetails = (struct Cell **)malloc(numRows * sizeof(struct Cell *));
-    for (int i = 0; i < numRows; i++) {
-        cellDetails[i] = (struct Cell *)malloc(numCols * sizeof(struct Cell));
-    }
+void aStarSearch(const struct maze_bitmap *grid, struct Cell start, struct Cell dest) {
+    int numRows = grid->rows, numCols = grid->cols;
+    int numCells = numRows * grid->stride;
+    STATS_DECLARE(stats, "astar");
 
-    // Closed list to track visited cells
-    bool **closedList = (bool **)malloc
-    (numRows * sizeof(bool *));
-    for (int i = 0; i < numRows; i++) {
-        closedList[i] = (bool *)calloc(numCols, sizeof(bool));
+    // Array to hold details of each cell, indexed like the grid
+    struct Cell *cellDetails = (struct Cell *)malloc(numCells * sizeof(struct Cell));
+
+    // Closed list to track visited cells, one bit per cell
+    struct maze_bitmap closedList;
+    maze_bitmap_alloc(&closedList, numRows, numCols);
+    if (!cellDetails) {
+        printf("Error: Cannot allocate A* state.\n");
+        exit(EXIT_FAILURE);
     }
 
     // Initialize all cell details
-    for (int i = 0; i < numRows; i++) {
-        for (int j = 0; j < numCols; j++) {
-            cellDetails[i][j].f = INT_MAX;
-            cellDetails[i][j].g = INT_MAX;
-            cellDetails[i][j].h = INT_MAX;
-            cellDetails[i][j].row = -1;
-            cellDetails[i][j].col = -1;
-        }
+    for (int c = 0; c < numCells; c++) {
+        cellDetails[c].f = INT_MAX;
+        cellDetails[c].g = INT_MAX;
+        cellDetails[c].h = INT_MAX;
+        cellDetails[c].row = -1;
+        cellDetails[c].col = -1;
     }
 
     // Initialize the starting cell details
     int i = start.row;
     int j = start.col;
-    cellDetails[i][j].f = 0;
-    cellDetails[i][j].g = 0;
-    cellDetails[i][j].h = 0;
-    cellDetails[i][j].row = i;
-    cellDetails[i][j].col = j;
-
-    // Create lists for open cells
-    bool **openList = (bool **)malloc(numRows * sizeof(bool *));
-    for (int i = 0; i < numRows; i++) {
-        openList[i] = (bool *)calloc(numCols, sizeof(bool));
-    }
-    openList[i][j] = true;
+    int startCell = maze_bit_index(grid, i, j);
+    cellDetails[startCell].f = 0;
+    cellDetails[startCell].g = 0;
+    cellDetails[startCell].h = 0;
+    cellDetails[startCell].row = i;
+    cellDetails[startCell].col = j;
+
+    // Create the open list; cells are keyed by their linear index
+    struct OpenList *openList = createOpenList(numCells, openListKind);
+    struct Heuristic heuristic;
+    setHeuristic(&heuristic, heuristicKind, grid->stride, maze_bit_index(grid, dest.row, dest.col), heuristicLandmarks);
+    openListPush(openList, startCell, 0);
+    STATS_INC(stats, generated);
+    STATS_ADD(stats, state_bytes, (long long)numCells * sizeof(struct Cell) + maze_bitmap_bytes(&closedList) + openListBytes(openList));
+    STATS_PHASE(stats, "search");
+
+    // Adjacent cells (up, down, left, right) as row/column and linear offsets
+    const int directions[4][2] = { {-1, 0}, {1, 0}, {0, -1}, {0, 1} };
+    int offsets[4];
+    maze_neighbor_offsets(grid->stride, directions, offsets);
 
     // Main loop
     while (true) {
-        int minF = INT_MAX;
-        int minIndex_i = -1, minIndex_j = -1;
-
-        // Find the cell with the minimum f value from the open list
-        for (int i = 0; i < numRows; i++) {
-            for (int j = 0; j < numCols; j++) {
-                if (openList[i][j] && cellDetails[i][j].f < minF) {
-                    minF = cellDetails[i][j].f;
-                    minIndex_i = i;
-                    minIndex_j = j;
-                }
-            }
-        }
+        // Take the cell with the minimum f value from the open list
+        int minCell = openListPop(openList);
 
         // No path exists
-        if (minIndex_i == -1 || minIndex_j == -1) {
+        if (minCell == -1) {
             printf("Destination not reachable\n");
-            return;
+            break;
         }
+        int minIndex_i = minCell / grid->stride;
+        int minIndex_j = minCell % grid->stride;
 
-        // Remove the selected cell from the open list and add to the closed list
-        openList[minIndex_i][minIndex_j] = false;
-        closedList[minIndex_i][minIndex_j] = true;
+        // Add the selected cell to the closed list
+        maze_bit_set(&closedList, minCell);
+        STATS_INC(stats, expanded);
 
         // Check all the adjacent cells (up, down, left, right)
-        int newRow, newCol;
-        int rowOffsets[] = {-1, 1, 0, 0};
-        int colOffsets[] = {0, 0, -1, 1};
         for (int k = 0; k < 4; k++) {
-            newRow = minIndex_i + rowOffsets[k];
-            newCol = minIndex_j + colOffsets[k];
+            int newRow = minIndex_i + directions[k][0];
+            int newCol = minIndex_j + directions[k][1];
+            int newCell = minCell + offsets[k];
 
             // If the cell is valid, not blocked, and not in the closed list
-            if (isValid(newRow, newCol, numRows, numCols) && isUnblocked(grid, newRow, newCol) && !closedList[newRow][newCol]) {
+            if (isValid(newRow, newCol, numRows, numCols) && !maze_bit_test(grid, newCell) && !maze_bit_test(&closedList, newCell)) {
                 int gNew, hNew, fNew;
 
-                gNew = cellDetails[minIndex_i][minIndex_j].g + 1; // Cost of moving to the next cell is 1
-                hNew = calculateHValue(newRow, newCol, dest);
+                gNew = cellDetails[minCell].g + 1; // Cost of moving to the next cell is 1
+                hNew = heuristicValue(&heuristic, newCell);
                 fNew = gNew + hNew;
 
                 // If the cell is not in the open list, add it to the open list
                 // and update its details
-                if (cellDetails[newRow][newCol].f == INT_MAX || cellDetails[newRow][newCol].f > fNew) {
-                    openList[newRow][newCol] = true;
-                    cellDetails[newRow][newCol].f = fNew;
-                    cellDetails[newRow][newCol].g = gNew;
-                    cellDetails[newRow][newCol].h = hNew;
-                    cellDetails[newRow][newCol].row = minIndex_i;
-                    cellDetails[newRow][newCol].col = minIndex_j;
+                if (cellDetails[newCell].f == INT_MAX || cellDetails[newCell].f > fNew) {
+                    STATS_INC(stats, generated);
+                    if (cellDetails[newCell].f != INT_MAX) {
+                        STATS_INC(stats, reopened);
+                    }
+                    openListPush(openList, newCell, fNew);
+                    STATS_MAX(stats, peak_open, openList->size);
+                    cellDetails[newCell].f = fNew;
+                    cellDetails[newCell].g = gNew;
+                    cellDetails[newCell].h = hNew;
+                    cellDetails[newCell].row = minIndex_i;
+                    cellDetails[newCell].col = minIndex_j;
                 }
             }
         }
@@ -172,73 +178,82 @@ void aStarSearch(int **grid, int numRows, int numCols, struct Cell start, struct
         // If the destination is reached, trace and print the path
         if (isDestination(minIndex_i, minIndex_j, dest)) {
             printf("Destination found!\n");
-            tracePath(grid, cellDetails, dest, numRows, numCols, start);
-            return;
+            STATS_PHASE(stats, "trace");
+            tracePath(grid, cellDetails, dest, start);
+            break;
         }
     }
+
+    STATS_REPORT(stats);
+    freeOpenList(openList);
+    free(cellDetails);
+    maze_bitmap_free(&closedList);
 }
 
-int main() {
-    int numRows, numCols;
-    char temp;
-    // printf("Enter the number of rows and columns: ");
-    FILE *fp1;
-    fp1 = fopen("maze.txt", "r");
-    fscanf(fp1, "%d,%d", &numRows, &numCols);
-    printf("%d %d\n", numRows, numCols);
+int main(int argc, char *argv[]) {
+    const char *mazePath = "maze.txt";
+    int arg = 1;
+    if (argc > arg && parseOpenListKind(argv[arg], &openListKind)) {
+        arg++;
+    }
+    if (argc > arg && parseHeuristicKind(argv[arg], &heuristicKind)) {
+        arg++;
+    }
+    if (argc > arg) {
+        mazePath = argv[arg++];
+    }
+    if (argc > arg) {
+        printf("Usage: %s [heap|bucket] [manhattan|zero|alt] [maze file]\n", argv[0]);
+        return 1;
+    }
 
-    // Dynamically allocate memory for the grid
-    int **grid = (int **)malloc(numRows * sizeof(int *));
-    for (int i = 0; i < numRows; i++) {
-        grid[i] = (int *)malloc(numCols * sizeof(int));
+    // Text mazes and .mzb files both load through maze_file_open
+    struct maze_file file;
+    if (maze_file_open(&file, mazePath) < 0) {
+        return 1;
     }
+    int numRows = file.rows, numCols = file.cols;
+    printf("%d %d\n", numRows, numCols);
 
-    // Input the grid
-    // printf("Enter the grid (0 for unblocked, 1 for blocked):\n");
-    struct Cell start;
-    struct Cell dest;
-    for (int i = 0; i < numRows; i++) {
-        for (int j = 0; j < numCols; j++) {
-            fscanf(fp1, "%c", &temp);
-			if(temp == ' '){
-				grid[i][j] = 0;
-			}
-            else if(temp == 'x'){
-				grid[i][j] = 1;
-			}
-            else if(temp == 's'){
-				start.row = i;
-                start.col = j;
-                grid[i][j] = 0;
-			}
-            else if(temp == 'g'){
-				dest.row = i;
-                dest.col = j;
-                grid[i][j] = 0;
-			}
-            else if(temp == '\n'){
-				j--;
-			}
-        }
+    // The grid is a wall bitmap: one bit per cell, set for blocked cells
+    struct maze_bitmap grid;
+    maze_file_to_bitmap(&file, &grid, 'x');
+    struct Cell start = { .row = file.start_row, .col = file.start_col };
+    struct Cell dest = { .row = file.goal_row, .col = file.goal_col };
+    maze_file_close(&file);
+    if (start.row < 0 || dest.row < 0) {
+        printf("Error: %s has no start or goal.\n", mazePath);
+        maze_bitmap_free(&grid);
+        return 1;
     }
 
     for (int k = 0; k < numRows; k++)
     {
         for (int l = 0; l < numCols; l++)
         {
-            printf("%d ", grid[k][l]);
+            printf("%d ", maze_bit_test(&grid, maze_bit_index(&grid, k, l)));
         }
         printf("\n");
     }
     
+    // ALT landmark tables are cached next to the maze and rebuilt when it changes
+    struct Landmarks landmarks = {0};
+    if (heuristicNeedsLandmarks(heuristicKind)) {
+        if (prepareLandmarks(&landmarks, mazePath, &grid, ALT_DEFAULT_LANDMARKS) < 0) {
+            maze_bitmap_free(&grid);
+            return 1;
+        }
+        heuristicLandmarks = &landmarks;
+    }
+
     // Find the path
-    aStarSearch(grid, numRows, numCols, start, dest);
+    aStarSearch(&grid, start, dest);
 
     // Free dynamically allocated memory
-    for (int i = 0; i < numRows; i++) {
-        free(grid[i]);
+    if (heuristicLandmarks) {
+        freeLandmarks(&landmarks);
     }
-    free(grid);
+    maze_bitmap_free(&grid);
 
     return 0;
 }
@@ -2,23 +2,15 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <limits.h>
+#include <string.h>
+#include "Astar_code.h"
+#include "search_stats.h"
 
-// Define a structure to represent each cell in the grid
-struct Cell {
-    int row, col; // Coordinates of the cell
-    int f, g, h;  // A* parameters: f = g + h, g = cost to start, h = heuristic to destination
-};
+enum OpenListKind openListKind = OPEN_LIST_HEAP;
+enum HeuristicKind heuristicKind = HEURISTIC_DEFAULT;
+const struct Landmarks *heuristicLandmarks = NULL;
 
-// Function prototypes
-bool isValid(int row, int col, int numRows, int numCols);
-bool isUnblocked(int **grid, int row, int col);
-bool isDestination(int row, int col, struct Cell dest);
-int calculateHValue(int row, int col, struct Cell dest);
-void tracePath(int **grid, struct Cell **cellDetails, struct Cell dest, int numRows, int numCols, struct Cell start);
-void aStarSearch(int **grid, int numRows, int numCols, struct Cell start, struct Cell dest);
-int **readGridFromFile(const char *filename, int *numRows, int *numCols, struct Cell *start, struct Cell *dest);
-void printGrid(int **grid, int numRows, int numCols);
-void freeMemory(int **grid, int numRows, struct Cell **cellDetails, bool **openList, bool **closedList);
+void freeMemory(struct Cell *cellDetails, struct OpenList *openList, struct maze_bitmap *closedList);
 
 
 // Function to check if a cell is within grid bounds
@@ -27,8 +19,8 @@ bool isValid(int row, int col, int numRows, int numCols) {
 }
 
 // Function to check if a cell is not blocked
-bool isUnblocked(int **grid, int row, int col) {
-    return grid[row][col] == 0;
+bool isUnblocked(const struct maze_bitmap *grid, int row, int col) {
+    return !maze_bit_test(grid, maze_bit_index(grid, row, col));
 }
 
 // Function to check if a cell is the destination
@@ -36,182 +28,274 @@ bool isDestination(int row, int col, struct Cell dest) {
     return row == dest.row && col == dest.col;
 }
 
-// Heuristic function: Manhattan distance
-int calculateHValue(int row, int col, struct Cell dest) {
-    return abs(row - dest.row) + abs(col - dest.col);
-}
-
 // Function to trace the path
-void tracePath(int **grid, struct Cell **cellDetails, struct Cell dest, int numRows, int numCols, struct Cell start) {
+void tracePath(const struct maze_bitmap *grid, struct Cell *cellDetails, struct Cell dest, struct Cell start) {
     printf("Tracing the path...\n");
     int row = dest.row, col = dest.col;
 
-    FILE *fp = fopen("sol.txt", "w");
+    // One bit per cell on the path
+    struct maze_bitmap path;
+    maze_bitmap_alloc(&path, grid->rows, grid->cols);
 
-    while (!(cellDetails[row][col].row == row && cellDetails[row][col].col == col)) {
-        grid[row][col] = 2; // Mark as path
-        int tempRow = cellDetails[row][col].row;
-        int tempCol = cellDetails[row][col].col;
-        row = tempRow;
-        col = tempCol;
+    int idx = maze_bit_index(grid, row, col);
+    while (!(cellDetails[idx].row == row && cellDetails[idx].col == col)) {
+        maze_bit_set(&path, idx); // Mark as path
+        row = cellDetails[idx].row;
+        col = cellDetails[idx].col;
+        idx = maze_bit_index(grid, row, col);
     }
-    grid[row][col] = 2; // Mark start as part of the path
-
-    for (int i = 0; i < numRows; i++) {
-        for (int j = 0; j < numCols; j++) {
-            if (i == start.row && j == start.col) {
-                fprintf(fp, "s");
-            } else if (i == dest.row && j == dest.col) {
-                fprintf(fp, "g");
-            } else if (grid[i][j] == 0) {
-                fprintf(fp, " ");
-            } else if (grid[i][j] == 1) {
-                fprintf(fp, "x");
-            } else if (grid[i][j] == 2) {
-                fprintf(fp, ".");
+    maze_bit_set(&path, idx); // Mark start as part of the path
+
+    // Render whole rows from the bitmaps, then place the start and destination
+    struct maze_writer writer;
+    if (maze_writer_open(&writer, "sol.txt") == 0) {
+        for (int i = 0; i < grid->rows; i++) {
+            char *line = maze_writer_reserve(&writer, grid->cols + 1);
+            maze_render_row(line, grid, &path, i);
+            if (i == start.row) {
+                line[start.col] = 's';
             }
+            if (i == dest.row) {
+                line[dest.col] = 'g';
+            }
+            line[grid->cols] = '\n';
         }
-        fprintf(fp, "\n");
+        maze_writer_close(&writer);
     }
-    fclose(fp);
+    maze_bitmap_free(&path);
 }
 
-// Function to read grid from a file
-int **readGridFromFile(const char *filename, int *numRows, int *numCols, struct Cell *start, struct Cell *dest) {
-    FILE *fp = fopen(filename, "r");
-    if (!fp) {
-        printf("Error opening file!\n");
+// Function to read grid from a file into a wall bitmap
+void readGridFromFile(const char *filename, struct maze_bitmap *grid, struct Cell *start, struct Cell *dest) {
+    struct maze_file file;
+    if (maze_file_open(&file, filename) < 0) {
         exit(EXIT_FAILURE);
     }
 
-    fscanf(fp, "%d,%d\n", numRows, numCols);
-
-    int **grid = (int **)malloc(*numRows * sizeof(int *));
-    for (int i = 0; i < *numRows; i++) {
-        grid[i] = (int *)malloc(*numCols * sizeof(int));
-    }
-
-    char temp;
-    for (int i = 0; i < *numRows; i++) {
-        for (int j = 0; j < *numCols; j++) {
-            fscanf(fp, "%c", &temp);
-            if (temp == 's') {
-                start->row = i;
-                start->col = j;
-                grid[i][j] = 0;
-            } else if (temp == 'g') {
-                dest->row = i;
-                dest->col = j;
-                grid[i][j] = 0;
-            } else if (temp == 'x') {
-                grid[i][j] = 1;
-            } else if (temp == ' ') {
-                grid[i][j] = 0;
-            } else if (temp == '\n') {
-                j--;
-            }
-        }
-    }
-    fclose(fp);
-    return grid;
+    maze_file_to_bitmap(&file, grid, 'x');
+    start->row = file.start_row;
+    start->col = file.start_col;
+    dest->row = file.goal_row;
+    dest->col = file.goal_col;
+    maze_file_close(&file);
 }
 
 // Function to print the grid
-void printGrid(int **grid, int numRows, int numCols) {
-    for (int i = 0; i < numRows; i++) {
-        for (int j = 0; j < numCols; j++) {
-            printf("%d ", grid[i][j]);
+void printGrid(const struct maze_bitmap *grid) {
+    for (int i = 0; i < grid->rows; i++) {
+        for (int j = 0; j < grid->cols; j++) {
+            printf("%d ", maze_bit_test(grid, maze_bit_index(grid, i, j)));
         }
         printf("\n");
     }
 }
 
 // A* search algorithm
-void aStarSearch(int **grid, int numRows, int numCols, struct Cell start, struct Cell dest) {
-    // Initialization
-    struct Cell **cellDetails = (struct Cell **)malloc(numRows * sizeof(struct Cell *));
-    for (int i = 0; i < numRows; i++) {
-        cellDetails[i] = (struct Cell *)malloc(numCols * sizeof(struct Cell));
-    }
+void aStarSearch(const struct maze_bitmap *grid, struct Cell start, struct Cell dest) {
+    int numRows = grid->rows, numCols = grid->cols;
+    int numCells = numRows * grid->stride;
+    STATS_DECLARE(stats, "astar");
 
-    bool **closedList = (bool **)calloc(numRows, sizeof(bool *));
-    bool **openList = (bool **)calloc(numRows, sizeof(bool *));
-    for (int i = 0; i < numRows; i++) {
-        closedList[i] = (bool *)calloc(numCols, sizeof(bool));
-        openList[i] = (bool *)calloc(numCols, sizeof(bool));
+    // Initialization: every per-cell array is flat and indexed like the grid
+    struct Cell *cellDetails = (struct Cell *)malloc(numCells * sizeof(struct Cell));
+    struct maze_bitmap closedList;
+    maze_bitmap_alloc(&closedList, numRows, numCols);
+    if (!cellDetails) {
+        printf("Error: Cannot allocate A* state.\n");
+        exit(EXIT_FAILURE);
     }
+    struct OpenList *openList = createOpenList(numCells, openListKind);
+    struct Heuristic heuristic;
+    setHeuristic(&heuristic, heuristicKind, grid->stride, maze_bit_index(grid, dest.row, dest.col), heuristicLandmarks);
 
     // Initialize start cell
     int i = start.row, j = start.col;
-    cellDetails[i][j] = (struct Cell){.row = i, .col = j, .f = 0, .g = 0, .h = 0};
-    openList[i][j] = true;
+    int startCell = maze_bit_index(grid, i, j);
+    cellDetails[startCell] = (struct Cell){.row = i, .col = j, .f = 0, .g = 0, .h = 0};
+    openListPush(openList, startCell, 0);
+    STATS_INC(stats, generated);
+    STATS_ADD(stats, state_bytes, (long long)numCells * sizeof(struct Cell) + maze_bitmap_bytes(&closedList) + openListBytes(openList));
+    STATS_PHASE(stats, "search");
+
+    // Adjacent cells: up, right, down, left
+    const int directions[4][2] = { {-1, 0}, {0, 1}, {1, 0}, {0, -1} };
+    int offsets[4];
+    maze_neighbor_offsets(grid->stride, directions, offsets);
 
     // Main algorithm
     while (true) {
-        int minF = INT_MAX;
-        int minRow = -1, minCol = -1;
-
-        // Find the cell with minimum f
-        for (int r = 0; r < numRows; r++) {
-            for (int c = 0; c < numCols; c++) {
-                if (openList[r][c] && cellDetails[r][c].f < minF) {
-                    minF = cellDetails[r][c].f;
-                    minRow = r;
-                    minCol = c;
-                }
-            }
-        }
+        // Take the cell with minimum f
+        int minCell = openListPop(openList);
 
-        if (minRow == -1) {
+        if (minCell == -1) {
             printf("Path not found!\n");
             break;
         }
+        int minRow = minCell / grid->stride;
+        int minCol = minCell % grid->stride;
 
-        openList[minRow][minCol] = false;
-        closedList[minRow][minCol] = true;
+        maze_bit_set(&closedList, minCell);
+        STATS_INC(stats, expanded);
 
         // Check adjacent cells
-        int rowOffsets[] = {-1, 0, 1, 0};
-        int colOffsets[] = {0, 1, 0, -1};
-
         for (int d = 0; d < 4; d++) {
-            int adjRow = minRow + rowOffsets[d];
-            int adjCol = minCol + colOffsets[d];
+            int adjRow = minRow + directions[d][0];
+            int adjCol = minCol + directions[d][1];
+            int adjCell = minCell + offsets[d];
 
-            if (isValid(adjRow, adjCol, numRows, numCols) && isUnblocked(grid, adjRow, adjCol)) {
+            if (isValid(adjRow, adjCol, numRows, numCols) && !maze_bit_test(grid, adjCell)) {
                 if (isDestination(adjRow, adjCol, dest)) {
-                    cellDetails[adjRow][adjCol].row = minRow;
-                    cellDetails[adjRow][adjCol].col = minCol;
+                    cellDetails[adjCell].row = minRow;
+                    cellDetails[adjCell].col = minCol;
                     printf("Path found!\n");
-                    tracePath(grid, cellDetails, dest, numRows, numCols, start);
+                    STATS_PHASE(stats, "trace");
+                    tracePath(grid, cellDetails, dest, start);
+                    STATS_REPORT(stats);
+#ifdef MAZE_STATS
+                    printf("Open-list operations: %lld pushes, %lld pops\n", openList->pushes, openList->pops);
+#endif
+                    freeMemory(cellDetails, openList, &closedList);
                     return;
                 }
 
-                if (!closedList[adjRow][adjCol]) {
-                    int gNew = cellDetails[minRow][minCol].g + 1;
-                    int hNew = calculateHValue(adjRow, adjCol, dest);
+                if (!maze_bit_test(&closedList, adjCell)) {
+                    int gNew = cellDetails[minCell].g + 1;
+                    int hNew = heuristicValue(&heuristic, adjCell);
                     int fNew = gNew + hNew;
 
-                    if (!openList[adjRow][adjCol] || cellDetails[adjRow][adjCol].f > fNew) {
-                        openList[adjRow][adjCol] = true;
-                        cellDetails[adjRow][adjCol] = (struct Cell){.row = minRow, .col = minCol, .g = gNew, .h = hNew, .f = fNew};
+                    if (!openListContains(openList, adjCell) || cellDetails[adjCell].f > fNew) {
+                        STATS_INC(stats, generated);
+                        if (openListContains(openList, adjCell)) {
+                            STATS_INC(stats, reopened);
+                        }
+                        openListPush(openList, adjCell, fNew);
+                        STATS_MAX(stats, peak_open, openList->size);
+                        cellDetails[adjCell] = (struct Cell){.row = minRow, .col = minCol, .g = gNew, .h = hNew, .f = fNew};
                     }
                 }
             }
         }
     }
 
-    freeMemory(grid, numRows, cellDetails, openList, closedList);
+    STATS_REPORT(stats);
+#ifdef MAZE_STATS
+    printf("Open-list operations: %lld pushes, %lld pops\n", openList->pushes, openList->pops);
+#endif
+    freeMemory(cellDetails, openList, &closedList);
 }
 
 // Free dynamically allocated memory
-void freeMemory(int **grid, int numRows, struct Cell **cellDetails, bool **openList, bool **closedList) {
-    for (int i = 0; i < numRows; i++) {
-        free(cellDetails[i]);
-        free(openList[i]);
-        free(closedList[i]);
-    }
+void freeMemory(struct Cell *cellDetails, struct OpenList *openList, struct maze_bitmap *closedList) {
     free(cellDetails);
-    free(openList);
-    free(closedList);
-}
\ No newline at end of file
+    freeOpenList(openList);
+    maze_bitmap_free(closedList);
+}
+
+// Function to allocate reusable A* state for a grid
+struct AStarContext *createAStarContext(const struct maze_bitmap *grid, enum OpenListKind kind) {
+    int numCells = grid->rows * grid->stride;
+    struct AStarContext *context = (struct AStarContext *)calloc(1, sizeof(struct AStarContext));
+    if (!context) {
+        printf("Error: Cannot allocate A* state.\n");
+        exit(EXIT_FAILURE);
+    }
+    context->grid = grid;
+    context->g = (int *)malloc(numCells * sizeof(int));
+    context->parent = (int *)malloc(numCells * sizeof(int));
+    context->seen = (unsigned *)calloc(numCells, sizeof(unsigned));
+    context->closed = (unsigned *)calloc(numCells, sizeof(unsigned));
+    if (!context->g || !context->parent || !context->seen || !context->closed) {
+        printf("Error: Cannot allocate A* state.\n");
+        exit(EXIT_FAILURE);
+    }
+    context->openList = createOpenList(numCells, kind);
+    context->heuristicKind = heuristicKind;
+    context->landmarks = heuristicLandmarks;
+    return context;
+}
+
+void freeAStarContext(struct AStarContext *context) {
+    free(context->g);
+    free(context->parent);
+    free(context->seen);
+    free(context->closed);
+    freeOpenList(context->openList);
+    free(context);
+}
+
+// A* query on reusable state; the sealed grid means neighbours never need a bounds check
+int aStarQuery(struct AStarContext *context, int start, int goal) {
+    const struct maze_bitmap *grid = context->grid;
+    int stride = grid->stride;
+    const int offsets[4] = { -stride, stride, -1, 1 };
+    STATS_DECLARE(stats, "astar");
+    context->expanded = 0;
+
+    // New stamp; on wrap-around the stamps are cleared once
+    if (++context->query == 0) {
+        memset(context->seen, 0, (size_t)grid->rows * stride * sizeof(unsigned));
+        memset(context->closed, 0, (size_t)grid->rows * stride * sizeof(unsigned));
+        context->query = 1;
+    }
+    unsigned query = context->query;
+    openListClear(context->openList);
+    if (maze_bit_test(grid, start) || maze_bit_test(grid, goal)) {
+        STATS_REPORT(stats);
+        return -1;
+    }
+    struct Heuristic heuristic;
+    setHeuristic(&heuristic, context->heuristicKind, stride, goal, context->landmarks);
+
+    context->g[start] = 0;
+    context->parent[start] = start;
+    context->seen[start] = query;
+    openListPush(context->openList, start, heuristicValue(&heuristic, start));
+    STATS_INC(stats, generated);
+    STATS_ADD(stats, state_bytes, (long long)grid->rows * stride * (2 * sizeof(int) + 2 * sizeof(unsigned)) +
+              openListBytes(context->openList));
+    STATS_PHASE(stats, "search");
+
+    int length = -1;
+    long long expanded = 0;
+    int cell;
+    while ((cell = openListPop(context->openList)) != -1) {
+        expanded++;
+        if (cell == goal) {
+            length = context->g[goal];
+            break;
+        }
+        context->closed[cell] = query;
+        STATS_INC(stats, expanded);
+        int gNew = context->g[cell] + 1;
+        for (int d = 0; d < 4; d++) {
+            int next = cell + offsets[d];
+            if (maze_bit_test(grid, next) || context->closed[next] == query) {
+                continue;
+            }
+            if (context->seen[next] != query || gNew < context->g[next]) {
+                STATS_INC(stats, generated);
+                if (context->seen[next] == query) {
+                    STATS_INC(stats, reopened);
+                }
+                context->seen[next] = query;
+                context->g[next] = gNew;
+                context->parent[next] = cell;
+                openListPush(context->openList, next, gNew + heuristicValue(&heuristic, next));
+                STATS_MAX(stats, peak_open, context->openList->size);
+            }
+        }
+    }
+    context->expanded = expanded;
+    STATS_REPORT(stats);
+    return length;
+}
+
+void aStarPathMoves(const struct AStarContext *context, int start, int goal, char *moves) {
+    int stride = context->grid->stride;
+    int i = context->g[goal];
+    moves[i] = '\0';
+    for (int cell = goal; cell != start; cell = context->parent[cell]) {
+        int step = cell - context->parent[cell];
+        moves[--i] = step == -stride ? 'U' : step == stride ? 'D' : step == -1 ? 'L' : 'R';
+    }
+}
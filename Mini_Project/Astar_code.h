@@ -0,0 +1,60 @@
+#ifndef ASTAR_CODE_H
+#define ASTAR_CODE_H
+
+#include <stdbool.h>
+#include "maze_core.h"
+#include "maze_bits.h"
+#include "maze_io.h"
+#include "open_list.h"
+#include "heuristic.h"
+
+// Define a structure to represent each cell in the grid
+struct Cell {
+    int row, col; // Coordinates of the cell
+    int f, g, h;  // A* parameters: f = g + h, g = cost to start, h = heuristic to destination
+};
+
+// Open list used by aStarSearch; callers may switch it before searching
+extern enum OpenListKind openListKind;
+
+// Heuristic used by aStarSearch and by contexts created afterwards (Manhattan, or the one fixed
+// at build time, by default); when heuristicNeedsLandmarks(heuristicKind) set heuristicLandmarks
+extern enum HeuristicKind heuristicKind;
+extern const struct Landmarks *heuristicLandmarks;
+
+// The A* grid is a sealed wall bitmap: one bit per cell, set for blocked cells
+bool isValid(int row, int col, int numRows, int numCols);
+bool isUnblocked(const struct maze_bitmap *grid, int row, int col);
+bool isDestination(int row, int col, struct Cell dest);
+void tracePath(const struct maze_bitmap *grid, struct Cell *cellDetails, struct Cell dest, struct Cell start);
+void aStarSearch(const struct maze_bitmap *grid, struct Cell start, struct Cell dest);
+void readGridFromFile(const char *filename, struct maze_bitmap *grid, struct Cell *start, struct Cell *dest);
+void printGrid(const struct maze_bitmap *grid);
+
+// A* state that is allocated once and reused for many queries on the same grid. Per-cell
+// entries are stamped with the query that last wrote them, so a new query starts in O(1)
+// instead of clearing every cell. One context per thread.
+struct AStarContext {
+    const struct maze_bitmap *grid;
+    int *g;                  // Cost from the start, valid when seen[cell] == query
+    int *parent;             // Cell each cell was reached from
+    unsigned *seen;          // Query that last set g and parent
+    unsigned *closed;        // Query that last closed the cell
+    unsigned query;
+    struct OpenList *openList;
+    long long expanded;      // Cells taken off the open list by the last query
+    enum HeuristicKind heuristicKind;        // heuristicKind and heuristicLandmarks at creation
+    const struct Landmarks *landmarks;
+};
+
+struct AStarContext *createAStarContext(const struct maze_bitmap *grid, enum OpenListKind kind);
+void freeAStarContext(struct AStarContext *context);
+
+// Shortest path length from start to goal (linear bitmap indices), or -1 if there is none
+int aStarQuery(struct AStarContext *context, int start, int goal);
+
+// Moves of the path found by the last successful aStarQuery, as 'U', 'D', 'L', 'R' into moves
+// (length + 1 bytes, NUL-terminated)
+void aStarPathMoves(const struct AStarContext *context, int start, int goal, char *moves);
+
+#endif
@@ -109,30 +109,71 @@ Coordinate get_entrance(char** maze, int rows, int cols) {
     return new_coordinate(-1, -1); // No entrance found
 }
 
-/* Recursive solver for the maze */
+/* One frame of the solver's explicit stack: a cell and the next direction to try from it */
+typedef struct {
+    int cell;           /* x * cols + y */
+    unsigned char next; /* index into the direction table below */
+} Frame;
+
+/* Directions tried by the solver: down, up, right, left */
+static const int solve_dx[4] = {1, -1, 0, 0};
+static const int solve_dy[4] = {0, 0, 1, -1};
+
+/* Depth-first solver using a growable explicit stack instead of recursion */
 Coordinate solve(Coordinate current, char** maze, int rows, int cols) {
     if (current.x == -1 || current.y == -1) return current;
     if (maze[current.x][current.y] == EXIT) return new_coordinate(-2, -2);
 
+    int size = 0, capacity = rows + cols;
+    Frame* stack = (Frame*)malloc(capacity * sizeof(Frame));
+    if (!stack) {
+        printf("Error: Could not allocate the solver stack.\n");
+        exit(1);
+    }
+
     maze[current.x][current.y] = VISITED;
+    stack[size].cell = current.x * cols + current.y;
+    stack[size].next = 0;
+    size++;
+
+    while (size > 0) {
+        Frame* top = &stack[size - 1];
+        int x = top->cell / cols, y = top->cell % cols;
+
+        if (top->next == 4) {
+            maze[x][y] = PATH; // Backtrack
+            size--;
+            continue;
+        }
 
-    Coordinate directions[] = {
-        new_coordinate(current.x + 1, current.y), // Down
-        new_coordinate(current.x - 1, current.y), // Up
-        new_coordinate(current.x, current.y + 1), // Right
-        new_coordinate(current.x, current.y - 1)  // Left
-    };
-
-    for (int i = 0; i < 4; i++) {
-        Coordinate next = directions[i];
-        if (next.x >= 0 && next.x < rows && next.y >= 0 && next.y < cols &&
-            (maze[next.x][next.y] == PATH || maze[next.x][next.y] == EXIT)) {
-            Coordinate result = solve(next, maze, rows, cols);
-            if (result.x == -2) return result;
+        int d = top->next++;
+        Coordinate next = new_coordinate(x + solve_dx[d], y + solve_dy[d]);
+        if (next.x < 0 || next.x >= rows || next.y < 0 || next.y >= cols ||
+            (maze[next.x][next.y] != PATH && maze[next.x][next.y] != EXIT)) {
+            continue;
+        }
+
+        if (maze[next.x][next.y] == EXIT) {
+            free(stack);
+            return new_coordinate(-2, -2);
+        }
+
+        if (size == capacity) {
+            capacity *= 2;
+            Frame* grown = (Frame*)realloc(stack, capacity * sizeof(Frame));
+            if (!grown) {
+                printf("Error: Could not grow the solver stack.\n");
+                exit(1);
+            }
+            stack = grown;
         }
+        maze[next.x][next.y] = VISITED;
+        stack[size].cell = next.x * cols + next.y;
+        stack[size].next = 0;
+        size++;
     }
 
-    maze[current.x][current.y] = PATH; // Backtrack
+    free(stack);
     return current;
 }
 
@@ -0,0 +1,95 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "ao_engine.h"
+#include "open_list.h"
+#include "search_stats.h"
+
+int ao_search(const struct maze_bitmap* walls, int start, int goal, struct maze_bitmap* path,
+              struct ao_stats* stats) {
+    struct ao_stats local = { 0, 0 };
+    STATS_DECLARE(counters, "ao");
+    if (maze_bit_test(walls, start) || maze_bit_test(walls, goal)) {
+        STATS_REPORT(counters);
+        if (stats) {
+            *stats = local;
+        }
+        return -1;
+    }
+
+    int stride = walls->stride;
+    int numCells = walls->rows * stride;
+    int goal_row = goal / stride, goal_col = goal % stride;
+    const int offsets[4] = { -stride, stride, -1, 1 };
+
+    // Moves from the start along the marked connectors, and the node each cell is marked from
+    int* g = (int*)malloc(numCells * sizeof(int));
+    int* parent = (int*)malloc(numCells * sizeof(int));
+    if (!g || !parent) {
+        printf("Error: Cannot allocate AO* state.\n");
+        exit(EXIT_FAILURE);
+    }
+    struct maze_bitmap generated, expanded;
+    maze_bitmap_alloc(&generated, walls->rows, walls->cols);
+    maze_bitmap_alloc(&expanded, walls->rows, walls->cols);
+    struct OpenList* open = createOpenList(numCells, OPEN_LIST_BUCKET);
+    STATS_ADD(counters, state_bytes, (long long)numCells * 2 * sizeof(int) +
+              2 * maze_bitmap_bytes(&generated) + openListBytes(open));
+    STATS_PHASE(counters, "search");
+
+    g[start] = 0;
+    parent[start] = -1;
+    maze_bit_set(&generated, start);
+    openListPush(open, start, abs(start / stride - goal_row) + abs(start % stride - goal_col));
+    STATS_INC(counters, generated);
+
+    int length = -1;
+    int node;
+    while ((node = openListPop(open)) != -1) {
+        if (node == goal) {
+            length = g[goal];
+            break;
+        }
+        maze_bit_set(&expanded, node);
+        local.expanded++;
+        STATS_INC(counters, expanded);
+
+        // Mark the connectors to new neighbours, and to open ones reached more cheaply
+        for (int d = 0; d < 4; d++) {
+            int next = node + offsets[d];
+            if (maze_bit_test(walls, next) || maze_bit_test(&expanded, next)) {
+                continue;
+            }
+            if (!maze_bit_test(&generated, next)) {
+                maze_bit_set(&generated, next);
+                STATS_INC(counters, generated);
+            } else if (g[node] + 1 < g[next]) {
+                local.remarked++;
+                STATS_INC(counters, reopened);
+            } else {
+                continue;
+            }
+            g[next] = g[node] + 1;
+            parent[next] = node;
+            openListPush(open, next, g[next] + abs(next / stride - goal_row) + abs(next % stride - goal_col));
+        }
+        STATS_MAX(counters, peak_open, open->size);
+    }
+
+    STATS_PHASE(counters, "trace");
+    if (length >= 0) {
+        for (int cell = goal; cell != start; cell = parent[cell]) {
+            maze_bit_set(path, parent[cell]);
+        }
+    }
+
+    STATS_REPORT(counters);
+    if (stats) {
+        *stats = local;
+    }
+    freeOpenList(open);
+    free(g);
+    free(parent);
+    maze_bitmap_free(&generated);
+    maze_bitmap_free(&expanded);
+    return length;
+}
@@ -0,0 +1,25 @@
+#ifndef AO_ENGINE_H
+#define AO_ENGINE_H
+
+#include "maze_bits.h"
+
+// Work done by one AO* search
+struct ao_stats {
+    long long expanded;   // Nodes expanded
+    long long remarked;   // Nodes marked again from a cheaper parent
+};
+
+// AO* over the maze's AND-OR graph. Every cell is an OR node whose connectors are its moves, and
+// in a single-agent maze each connector leads to one cell, so there are no AND nodes: the best
+// partial solution graph is a chain of marked connectors from the start, and AO* reduces to A*.
+// The engine is therefore A* with the Manhattan estimate. The open nodes are kept in a bucket
+// queue keyed on moves from the start plus estimate, ties go to the newest node so the search
+// keeps extending the chain it just marked, and a node reached more cheaply is marked from its
+// new parent. Each node is expanded once, and the path is optimal since the estimate is
+// consistent.
+// When the goal is reached every cell on the path (start included, goal excluded) is set in path,
+// like dfs_iterative. Returns the path length in moves, or -1 if the goal is unreachable.
+int ao_search(const struct maze_bitmap* walls, int start, int goal, struct maze_bitmap* path,
+              struct ao_stats* stats);
+
+#endif
@@ -0,0 +1,140 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+#include "maze_core.h"
+#include "maze_bits.h"
+#include "maze_io.h"
+#include "par_bfs.h"
+
+// Scaling benchmark for par_bfs: full BFS from the top-left free cell with 1, 2, 4, ... threads.
+// Mazes are either loaded (text or .mzb, e.g. from maze_generator) or generated in memory
+// with a fixed seed: about a quarter walls, so the frontier is wide enough to share.
+//
+// Usage: bfs_bench [max threads] [cells | maze file] ...
+// Defaults: the CPU count, and generated mazes of 10^6 and 10^7 cells.
+
+double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Square pseudo-random maze of about the requested number of cells. Returns -1 if it is too
+// large for int cell indices.
+int generate_walls(struct maze_bitmap *walls, long long cells) {
+    if (cells > INT_MAX) {
+        printf("Error: %lld cells is too large.\n", cells);
+        return -1;
+    }
+    int side = 1;
+    while ((long long)(side + 1) * (side + 1) <= cells) {
+        side++;
+    }
+    if ((long long)side * maze_stride_for(side) > INT_MAX) {
+        printf("Error: A %d x %d maze is too large.\n", side, side);
+        return -1;
+    }
+    maze_bitmap_alloc(walls, side, side);
+    unsigned long long state = 12345;
+    for (int i = 0; i < side; i++) {
+        for (int j = 0; j < side; j++) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            if ((state >> 62) == 0) {
+                maze_bit_set(walls, maze_bit_index(walls, i, j));
+            }
+        }
+    }
+    maze_bit_clear(walls, maze_bit_index(walls, 0, 0));
+    maze_bitmap_seal(walls);
+    return 0;
+}
+
+// Order-dependent checksum of the distance map, to check that every thread count agrees
+unsigned long long dist_checksum(const int *dist, int numCells) {
+    unsigned long long sum = 0;
+    for (int i = 0; i < numCells; i++) {
+        sum = sum * 31 + (unsigned)dist[i];
+    }
+    return sum;
+}
+
+void bench(const struct maze_bitmap *walls, const char *name, int max_threads) {
+    int numCells = walls->rows * walls->stride;
+    int *dist = (int *)malloc(numCells * sizeof(int));
+    atomic_int *parent = (atomic_int *)malloc(numCells * sizeof(atomic_int));
+    if (!dist || !parent) {
+        printf("Error: Cannot allocate BFS state for %s.\n", name);
+        exit(EXIT_FAILURE);
+    }
+
+    // Start from the first free cell in row-major order
+    int start = -1;
+    for (int i = 0; i < walls->rows && start < 0; i++) {
+        for (int j = 0; j < walls->cols; j++) {
+            if (!maze_bit_test(walls, maze_bit_index(walls, i, j))) {
+                start = maze_bit_index(walls, i, j);
+                break;
+            }
+        }
+    }
+    if (start < 0) {
+        printf("%s: no free cell\n", name);
+        free(dist);
+        free(parent);
+        return;
+    }
+
+    printf("%s: %d x %d (%lld cells)\n", name, walls->rows, walls->cols, (long long)walls->rows * walls->cols);
+    printf("%8s %12s %10s %14s %8s %s\n", "threads", "reached", "seconds", "cells/s", "speedup", "distances");
+    double base = 0;
+    unsigned long long expected = 0;
+    for (int t = 1; t <= max_threads; t = (t * 2 > max_threads && t < max_threads) ? max_threads : t * 2) {
+        double begin = now_seconds();
+        long long reached = par_bfs(walls, start, t, dist, parent);
+        double seconds = now_seconds() - begin;
+        unsigned long long sum = dist_checksum(dist, numCells);
+        if (t == 1) {
+            base = seconds;
+            expected = sum;
+        }
+        printf("%8d %12lld %10.3f %14.0f %7.2fx %s\n", t, reached, seconds, reached / seconds,
+               base / seconds, sum == expected ? "match" : "MISMATCH");
+    }
+    free(dist);
+    free(parent);
+}
+
+int main(int argc, char *argv[]) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int max_threads = argc > 1 ? atoi(argv[1]) : (int)(cpus > 0 ? cpus : 1);
+    if (max_threads < 1) {
+        printf("Usage: %s [max threads] [cells | maze file] ...\n", argv[0]);
+        return 1;
+    }
+
+    const char *defaults[] = { "1000000", "10000000" };
+    int count = argc > 2 ? argc - 2 : 2;
+    for (int k = 0; k < count; k++) {
+        const char *arg = argc > 2 ? argv[k + 2] : defaults[k];
+        char *end;
+        long long cells = strtoll(arg, &end, 10);
+        struct maze_bitmap walls;
+        if (*end == '\0' && cells > 0) {
+            if (generate_walls(&walls, cells) < 0) {
+                continue;
+            }
+        } else {
+            struct maze_file file;
+            if (maze_file_open(&file, arg) < 0) {
+                continue;
+            }
+            maze_file_to_bitmap(&file, &walls, 'x');
+            maze_file_close(&file);
+        }
+        bench(&walls, arg, max_threads);
+        maze_bitmap_free(&walls);
+    }
+    return 0;
+}
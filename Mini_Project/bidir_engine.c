@@ -0,0 +1,182 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "bidir_engine.h"
+#include "search_stats.h"
+
+#define SEEN_FORWARD 1
+#define SEEN_BACKWARD 2
+#define NO_MEETING UINT64_MAX
+
+// State shared by the two fronts
+struct bidir_shared {
+    const struct maze_bitmap* walls;
+    atomic_uchar* seen;            // Per cell: SEEN_FORWARD | SEEN_BACKWARD
+    int* dist[2];                  // Per side: moves from that side's origin, -1 if not reached
+    atomic_int depth[2];           // Per side: every cell this many moves away has been reached
+    atomic_uint_least64_t best;    // Best meeting so far: (length << 32) | cell
+    atomic_int stop;
+};
+
+// One front: which side it is and where it starts
+struct bidir_front {
+    struct bidir_shared* shared;
+    int side;
+    int origin;
+#ifdef MAZE_STATS
+    struct search_stats stats;     // This side's counters, added up after the join
+#endif
+};
+
+// Keep the shorter of the current best meeting and this one
+static void offer_meeting(struct bidir_shared* shared, int length, int cell) {
+    uint64_t candidate = ((uint64_t)length << 32) | (uint32_t)cell;
+    uint64_t current = atomic_load(&shared->best);
+    while (candidate < current && !atomic_compare_exchange_weak(&shared->best, &current, candidate)) {
+    }
+}
+
+// Mark a cell as reached by this side and offer a meeting if the other side got there first.
+// dist[side][cell] is written before the flag, so the other side can read it once it sees the flag.
+static void reach(struct bidir_shared* shared, int side, int cell) {
+    unsigned char mine = side == 0 ? SEEN_FORWARD : SEEN_BACKWARD;
+    unsigned char before = atomic_fetch_or(&shared->seen[cell], mine);
+    if (before & ~mine) {
+        offer_meeting(shared, shared->dist[side][cell] + shared->dist[1 - side][cell], cell);
+    }
+}
+
+// Thread body: breadth-first search one level at a time until the fronts are known to have met
+// on a shortest path, or this side runs out of cells
+static void* run_front(void* arg) {
+    struct bidir_front* front = (struct bidir_front*)arg;
+    struct bidir_shared* shared = front->shared;
+    const struct maze_bitmap* walls = shared->walls;
+    int side = front->side;
+    int numCells = walls->rows * walls->stride;
+    int offsets[4] = { -walls->stride, walls->stride, -1, 1 };
+
+    int* dist = shared->dist[side];
+    for (int i = 0; i < numCells; i++) {
+        dist[i] = -1;
+    }
+    int* queue = (int*)malloc(numCells * sizeof(int));
+    if (!queue) {
+        printf("Error: Cannot allocate the search queue.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    int head = 0, tail = 0, depth = 0;
+    dist[front->origin] = 0;
+    queue[tail++] = front->origin;
+    reach(shared, side, front->origin);
+
+    while (!atomic_load(&shared->stop)) {
+        int levelEnd = tail;
+        STATS_MAX(front->stats, peak_open, levelEnd - head);
+        if (head == levelEnd) {
+            // Everything reachable from this side has been seen, so every meeting has been offered
+            atomic_store(&shared->stop, 1);
+            break;
+        }
+        while (head < levelEnd) {
+            int cell = queue[head++];
+            for (int d = 0; d < 4; d++) {
+                int next = cell + offsets[d];
+                if (!maze_bit_test(walls, next) && dist[next] < 0) {
+                    dist[next] = depth + 1;
+                    queue[tail++] = next;
+                    reach(shared, side, next);
+                }
+            }
+        }
+        depth++;
+        atomic_store(&shared->depth[side], depth);
+
+        // Any path not offered yet is longer than depth + the other side's depth
+        uint64_t best = atomic_load(&shared->best);
+        if (best != NO_MEETING && (int)(best >> 32) <= depth + atomic_load(&shared->depth[1 - side])) {
+            atomic_store(&shared->stop, 1);
+        }
+    }
+
+    STATS_ADD(front->stats, expanded, head);
+    STATS_ADD(front->stats, generated, tail);
+    STATS_ADD(front->stats, state_bytes, (long long)numCells * (sizeof(int) + sizeof(int)));
+    free(queue);
+    return NULL;
+}
+
+// Walk from cell towards the origin of dist, always to a neighbour one move closer
+static void mark_back(const struct maze_bitmap* walls, const int* dist, int cell, struct maze_bitmap* path) {
+    int offsets[4] = { -walls->stride, walls->stride, -1, 1 };
+    maze_bit_set(path, cell);
+    while (dist[cell] > 0) {
+        for (int d = 0; d < 4; d++) {
+            int next = cell + offsets[d];
+            if (!maze_bit_test(walls, next) && dist[next] == dist[cell] - 1) {
+                cell = next;
+                break;
+            }
+        }
+        maze_bit_set(path, cell);
+    }
+}
+
+int bidir_bfs(const struct maze_bitmap* walls, int start, int goal, struct maze_bitmap* path) {
+    int numCells = walls->rows * walls->stride;
+    STATS_DECLARE(stats, "bidir");
+    struct bidir_shared shared;
+    shared.walls = walls;
+    shared.seen = (atomic_uchar*)calloc(numCells, sizeof(atomic_uchar));
+    shared.dist[0] = (int*)malloc(numCells * sizeof(int));
+    shared.dist[1] = (int*)malloc(numCells * sizeof(int));
+    if (!shared.seen || !shared.dist[0] || !shared.dist[1]) {
+        printf("Error: Cannot allocate bidirectional search state.\n");
+        exit(EXIT_FAILURE);
+    }
+    atomic_init(&shared.depth[0], 0);
+    atomic_init(&shared.depth[1], 0);
+    atomic_init(&shared.best, NO_MEETING);
+    atomic_init(&shared.stop, 0);
+
+    struct bidir_front fronts[2] = { { .shared = &shared, .side = 0, .origin = start }, { .shared = &shared, .side = 1, .origin = goal } };
+    STATS_PHASE(stats, "search");
+    pthread_t threads[2];
+    for (int i = 0; i < 2; i++) {
+        if (pthread_create(&threads[i], NULL, run_front, &fronts[i]) != 0) {
+            printf("Error: Cannot start search thread.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (int i = 0; i < 2; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    STATS_PHASE(stats, "trace");
+    for (int i = 0; i < 2; i++) {
+        STATS_ADD(stats, expanded, fronts[i].stats.expanded);
+        STATS_ADD(stats, generated, fronts[i].stats.generated);
+        STATS_ADD(stats, peak_open, fronts[i].stats.peak_open);
+        STATS_ADD(stats, state_bytes, fronts[i].stats.state_bytes);
+    }
+    STATS_ADD(stats, state_bytes, (long long)numCells * sizeof(atomic_uchar));
+
+    int length = -1;
+    uint64_t best = atomic_load(&shared.best);
+    if (best != NO_MEETING) {
+        length = (int)(best >> 32);
+        int meet = (int)(uint32_t)best;
+        mark_back(walls, shared.dist[0], meet, path);
+        mark_back(walls, shared.dist[1], meet, path);
+        maze_bit_clear(path, goal);
+    }
+
+    STATS_REPORT(stats);
+    free(shared.seen);
+    free(shared.dist[0]);
+    free(shared.dist[1]);
+    return length;
+}
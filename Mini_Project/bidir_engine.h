@@ -0,0 +1,15 @@
+#ifndef BIDIR_ENGINE_H
+#define BIDIR_ENGINE_H
+
+#include "maze_bits.h"
+
+// Bidirectional breadth-first search over a sealed wall bitmap. A forward front from start and
+// a backward front from goal run on their own threads, level by level. The only shared state
+// per cell is an atomic byte of "seen by" flags: whichever side reaches a cell second finds the
+// other's flag and offers a meeting, kept as an atomic minimum. A side stops once the best
+// meeting is no longer than the sum of both fronts' finished depths, so the path is optimal.
+// Every cell on the path (start included, goal excluded) is set in path, like dfs_iterative.
+// Returns the path length in moves, or -1 if the goal is unreachable.
+int bidir_bfs(const struct maze_bitmap* walls, int start, int goal, struct maze_bitmap* path);
+
+#endif
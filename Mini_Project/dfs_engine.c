@@ -0,0 +1,103 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "dfs_engine.h"
+#include "search_stats.h"
+
+void dfs_stack_init(struct dfs_stack* stack, int capacity) {
+    if (capacity < 16) {
+        capacity = 16;
+    }
+    stack->frames = (struct dfs_frame*)malloc(capacity * sizeof(struct dfs_frame));
+    if (!stack->frames) {
+        printf("Error: Cannot allocate DFS stack.\n");
+        exit(EXIT_FAILURE);
+    }
+    stack->size = 0;
+    stack->capacity = capacity;
+}
+
+void dfs_stack_free(struct dfs_stack* stack) {
+    free(stack->frames);
+    stack->frames = NULL;
+    stack->size = 0;
+    stack->capacity = 0;
+}
+
+void dfs_stack_push(struct dfs_stack* stack, int cell) {
+    if (stack->size == stack->capacity) {
+        int capacity = stack->capacity * 2;
+        struct dfs_frame* frames = (struct dfs_frame*)realloc(stack->frames, capacity * sizeof(struct dfs_frame));
+        if (!frames) {
+            printf("Error: Cannot grow DFS stack to %d frames.\n", capacity);
+            exit(EXIT_FAILURE);
+        }
+        stack->frames = frames;
+        stack->capacity = capacity;
+    }
+    stack->frames[stack->size].cell = cell;
+    stack->frames[stack->size].next_dir = 0;
+    stack->size++;
+}
+
+int dfs_iterative(const struct maze_bitmap* walls, struct maze_bitmap* visited, struct maze_bitmap* path,
+                  int start, int goal, const int directions[4][2]) {
+    STATS_DECLARE(stats, "dfs");
+    if (start == goal) {
+        STATS_REPORT(stats);
+        return 1;
+    }
+    if (maze_bit_test(walls, start) || maze_bit_test(visited, start)) {
+        STATS_REPORT(stats);
+        return 0;
+    }
+
+    // Linear offset of each direction and its bit in maze_bits_open_neighbors()
+    int offsets[4];
+    unsigned dir_bits[4];
+    maze_neighbor_offsets(walls->stride, directions, offsets);
+    for (int i = 0; i < 4; i++) {
+        dir_bits[i] = directions[i][0] < 0 ? 1u : directions[i][0] > 0 ? 2u : directions[i][1] < 0 ? 4u : 8u;
+    }
+
+    struct dfs_stack stack;
+    dfs_stack_init(&stack, walls->rows + walls->cols);
+
+    maze_bit_set(visited, start);
+    dfs_stack_push(&stack, start);
+    STATS_INC(stats, generated);
+    STATS_PHASE(stats, "search");
+
+    int found = 0;
+    while (stack.size > 0 && !found) {
+        struct dfs_frame* top = &stack.frames[stack.size - 1];
+        if (top->next_dir == 4) {
+            stack.size--;  // All directions tried, backtrack
+            continue;
+        }
+        if (top->next_dir == 0) {
+            STATS_INC(stats, expanded);
+        }
+
+        int dir = top->next_dir++;
+        int next = top->cell + offsets[dir];
+        if (next == goal) {
+            found = 1;
+        } else if (maze_bits_open_neighbors(walls, visited, top->cell) & dir_bits[dir]) {
+            maze_bit_set(visited, next);
+            dfs_stack_push(&stack, next);
+            STATS_INC(stats, generated);
+            STATS_MAX(stats, peak_open, stack.size);
+        }
+    }
+    STATS_PHASE(stats, "trace");
+
+    // The frames left on the stack are the path from the start to the goal
+    for (int i = 0; i < stack.size; i++) {
+        maze_bit_set(path, stack.frames[i].cell);
+    }
+
+    STATS_ADD(stats, state_bytes, (long long)stack.capacity * sizeof(struct dfs_frame));
+    STATS_REPORT(stats);
+    dfs_stack_free(&stack);
+    return found;
+}
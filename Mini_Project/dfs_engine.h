@@ -0,0 +1,31 @@
+#ifndef DFS_ENGINE_H
+#define DFS_ENGINE_H
+
+#include "maze_bits.h"
+
+// One stack frame: the cell being expanded and the next direction to try
+struct dfs_frame {
+    int cell;                 // Linear index into the grid
+    unsigned char next_dir;   // 0..3, index into the direction table
+};
+
+// Growable explicit stack, so search depth is bounded by heap memory rather than thread stack size
+struct dfs_stack {
+    struct dfs_frame* frames;
+    int size;
+    int capacity;
+};
+
+void dfs_stack_init(struct dfs_stack* stack, int capacity);
+void dfs_stack_free(struct dfs_stack* stack);
+void dfs_stack_push(struct dfs_stack* stack, int cell);
+
+// Non-recursive DFS from start to goal (linear indices) over a sealed wall bitmap. Every cell
+// entered is set in visited and, when the goal is reached, every cell on the current path
+// (start included, goal excluded) is set in path, the same cells the recursive dfs() marked
+// as crumbs. directions holds the (row, col) offsets in the order they are tried.
+// Returns 1 if the goal was found.
+int dfs_iterative(const struct maze_bitmap* walls, struct maze_bitmap* visited, struct maze_bitmap* path,
+                  int start, int goal, const int directions[4][2]);
+
+#endif
@@ -0,0 +1,263 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "dstar_engine.h"
+#include "search_stats.h"
+
+#define DSTAR_INF INT_MAX
+#define DSTAR_KEY_INF LLONG_MAX
+
+// Manhattan distance from the current start, the heuristic of the backward search
+static int dstar_h(const struct dstar_planner* planner, int cell) {
+    int stride = planner->walls.stride;
+    return abs(cell / stride - planner->start / stride) + abs(cell % stride - planner->start % stride);
+}
+
+// Key [min(g, rhs) + h + km; min(g, rhs)] packed into one integer, compared lexicographically
+static long long dstar_key(const struct dstar_planner* planner, int cell) {
+    int m = planner->g[cell] < planner->rhs[cell] ? planner->g[cell] : planner->rhs[cell];
+    if (m == DSTAR_INF) {
+        return DSTAR_KEY_INF;
+    }
+    return ((long long)(m + dstar_h(planner, cell) + planner->km) << 32) | (unsigned)m;
+}
+
+// Indexed binary heap on key
+static void heap_swap(struct dstar_planner* planner, int a, int b) {
+    int cell_a = planner->heap[a], cell_b = planner->heap[b];
+    planner->heap[a] = cell_b;
+    planner->heap[b] = cell_a;
+    planner->pos[cell_b] = a;
+    planner->pos[cell_a] = b;
+}
+
+static void heap_sift_up(struct dstar_planner* planner, int slot) {
+    while (slot > 0) {
+        int parent = (slot - 1) / 2;
+        if (planner->key[planner->heap[parent]] <= planner->key[planner->heap[slot]]) {
+            break;
+        }
+        heap_swap(planner, slot, parent);
+        slot = parent;
+    }
+}
+
+static void heap_sift_down(struct dstar_planner* planner, int slot) {
+    for (;;) {
+        int smallest = slot, left = 2 * slot + 1, right = left + 1;
+        if (left < planner->size && planner->key[planner->heap[left]] < planner->key[planner->heap[smallest]]) {
+            smallest = left;
+        }
+        if (right < planner->size && planner->key[planner->heap[right]] < planner->key[planner->heap[smallest]]) {
+            smallest = right;
+        }
+        if (smallest == slot) {
+            return;
+        }
+        heap_swap(planner, slot, smallest);
+        slot = smallest;
+    }
+}
+
+// Insert cell, or move it if it is already queued
+static void heap_set(struct dstar_planner* planner, int cell, long long key) {
+    planner->stats.pushes++;
+    planner->key[cell] = key;
+    int slot = planner->pos[cell];
+    if (slot < 0) {
+        slot = planner->size++;
+        planner->heap[slot] = cell;
+        planner->pos[cell] = slot;
+    }
+    heap_sift_up(planner, slot);
+    heap_sift_down(planner, planner->pos[cell]);
+}
+
+static void heap_remove(struct dstar_planner* planner, int cell) {
+    int slot = planner->pos[cell];
+    if (slot < 0) {
+        return;
+    }
+    int last = --planner->size;
+    if (slot != last) {
+        heap_swap(planner, slot, last);
+    }
+    planner->pos[cell] = -1;
+    if (slot != last) {
+        heap_sift_up(planner, slot);
+        heap_sift_down(planner, planner->pos[planner->heap[slot]]);
+    }
+}
+
+// Recompute rhs(cell) from its open neighbours and requeue it if it is inconsistent
+static void update_vertex(struct dstar_planner* planner, int cell) {
+    const struct maze_bitmap* walls = &planner->walls;
+    if (cell != planner->goal) {
+        int best = DSTAR_INF;
+        if (!maze_bit_test(walls, cell)) {
+            const int offsets[4] = { -walls->stride, walls->stride, -1, 1 };
+            for (int d = 0; d < 4; d++) {
+                int next = cell + offsets[d];
+                if (!maze_bit_test(walls, next) && planner->g[next] != DSTAR_INF && planner->g[next] + 1 < best) {
+                    best = planner->g[next] + 1;
+                }
+            }
+        }
+        planner->rhs[cell] = best;
+        planner->stats.updates++;
+    }
+    if (planner->g[cell] != planner->rhs[cell]) {
+        heap_set(planner, cell, dstar_key(planner, cell));
+    } else {
+        heap_remove(planner, cell);
+    }
+}
+
+// Walls never change rhs (it stays infinite), and the sealed border keeps next inside the maze
+static void update_neighbors(struct dstar_planner* planner, int cell) {
+    const struct maze_bitmap* walls = &planner->walls;
+    const int offsets[4] = { -walls->stride, walls->stride, -1, 1 };
+    for (int d = 0; d < 4; d++) {
+        int next = cell + offsets[d];
+        if (!maze_bit_test(walls, next)) {
+            update_vertex(planner, next);
+        }
+    }
+}
+
+// Expand inconsistent cells until the start is consistent and no queued key is below its key
+static int compute_shortest_path(struct dstar_planner* planner) {
+    STATS_DECLARE(counters, "dstar");
+    STATS_ADD(counters, state_bytes, (long long)planner->walls.rows * planner->walls.stride *
+              (3 * sizeof(int) + sizeof(long long)) + maze_bitmap_bytes(&planner->walls));
+    STATS_PHASE(counters, "search");
+#ifdef MAZE_STATS
+    long long pushes = planner->stats.pushes;
+#endif
+    int start = planner->start;
+    while (planner->size > 0 &&
+           (planner->key[planner->heap[0]] < dstar_key(planner, start) || planner->rhs[start] != planner->g[start])) {
+        int cell = planner->heap[0];
+        long long old_key = planner->key[cell];
+        long long new_key = dstar_key(planner, cell);
+        planner->stats.pops++;
+        STATS_INC(counters, expanded);
+        if (old_key < new_key) {
+            // Key went stale after a start move; requeue with the current one
+            heap_set(planner, cell, new_key);
+        } else if (planner->g[cell] > planner->rhs[cell]) {
+            // Overconsistent: the cell got closer to the goal
+            planner->g[cell] = planner->rhs[cell];
+            heap_remove(planner, cell);
+            update_neighbors(planner, cell);
+        } else {
+            // Underconsistent: its old distance is gone; raise it and let the neighbours recompute
+            planner->g[cell] = DSTAR_INF;
+            STATS_INC(counters, reopened);
+            update_vertex(planner, cell);
+            update_neighbors(planner, cell);
+        }
+        STATS_MAX(counters, peak_open, planner->size);
+    }
+    STATS_ADD(counters, generated, planner->stats.pushes - pushes);
+    STATS_REPORT(counters);
+    return planner->g[start] == DSTAR_INF ? -1 : planner->g[start];
+}
+
+int dstar_init(struct dstar_planner* planner, const struct maze_bitmap* walls, int start, int goal) {
+    memset(planner, 0, sizeof(*planner));
+    maze_bitmap_alloc(&planner->walls, walls->rows, walls->cols);
+    memcpy(planner->walls.words - walls->words_per_row, walls->words - walls->words_per_row,
+           (size_t)(walls->rows + 2) * walls->words_per_row * sizeof(uint64_t));
+    int numCells = walls->rows * walls->stride;
+    planner->g = (int*)malloc(numCells * sizeof(int));
+    planner->rhs = (int*)malloc(numCells * sizeof(int));
+    planner->key = (long long*)malloc(numCells * sizeof(long long));
+    planner->pos = (int*)malloc(numCells * sizeof(int));
+    planner->heap = (int*)malloc(numCells * sizeof(int));
+    if (!planner->g || !planner->rhs || !planner->key || !planner->pos || !planner->heap) {
+        printf("Error: Cannot allocate D* Lite state.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < numCells; i++) {
+        planner->g[i] = DSTAR_INF;
+        planner->rhs[i] = DSTAR_INF;
+        planner->pos[i] = -1;
+    }
+    planner->start = planner->last = start;
+    planner->goal = goal;
+    if (maze_bit_test(&planner->walls, start) || maze_bit_test(&planner->walls, goal)) {
+        return -1;
+    }
+    planner->rhs[goal] = 0;
+    heap_set(planner, goal, dstar_key(planner, goal));
+    return compute_shortest_path(planner);
+}
+
+void dstar_free(struct dstar_planner* planner) {
+    maze_bitmap_free(&planner->walls);
+    free(planner->g);
+    free(planner->rhs);
+    free(planner->key);
+    free(planner->pos);
+    free(planner->heap);
+    memset(planner, 0, sizeof(*planner));
+}
+
+int dstar_update(struct dstar_planner* planner, const struct dstar_change* changes, int count) {
+    struct maze_bitmap* walls = &planner->walls;
+    for (int i = 0; i < count; i++) {
+        int cell = changes[i].cell;
+        if (cell < 0 || cell >= walls->rows * walls->stride || cell % walls->stride >= walls->cols ||
+            cell == planner->start || cell == planner->goal || maze_bit_test(walls, cell) == changes[i].blocked) {
+            continue;
+        }
+        if (changes[i].blocked) {
+            maze_bit_set(walls, cell);
+        } else {
+            maze_bit_clear(walls, cell);
+        }
+        // Every edge into and out of the cell changed cost
+        update_vertex(planner, cell);
+        update_neighbors(planner, cell);
+    }
+    return compute_shortest_path(planner);
+}
+
+int dstar_move_start(struct dstar_planner* planner, int start) {
+    if (maze_bit_test(&planner->walls, start)) {
+        return -1;
+    }
+    planner->start = start;
+    planner->km += dstar_h(planner, planner->last);
+    planner->last = start;
+    return compute_shortest_path(planner);
+}
+
+int dstar_path(const struct dstar_planner* planner, struct maze_bitmap* path) {
+    const struct maze_bitmap* walls = &planner->walls;
+    const int offsets[4] = { -walls->stride, walls->stride, -1, 1 };
+    int length = planner->g[planner->start];
+    if (length == DSTAR_INF) {
+        return -1;
+    }
+    // Step to the open neighbour closest to the goal until the goal is reached
+    int cell = planner->start;
+    for (int step = 0; step < length; step++) {
+        maze_bit_set(path, cell);
+        int best = -1;
+        for (int d = 0; d < 4; d++) {
+            int next = cell + offsets[d];
+            if (!maze_bit_test(walls, next) && planner->g[next] != DSTAR_INF &&
+                (best < 0 || planner->g[next] < planner->g[best])) {
+                best = next;
+            }
+        }
+        if (best < 0) {
+            return -1;
+        }
+        cell = best;
+    }
+    return cell == planner->goal ? length : -1;
+}
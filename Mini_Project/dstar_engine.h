@@ -0,0 +1,58 @@
+#ifndef DSTAR_ENGINE_H
+#define DSTAR_ENGINE_H
+
+#include <stdbool.h>
+#include "maze_bits.h"
+
+// Incremental replanning with D* Lite (LPA* searching backwards from the goal) on a 4-connected,
+// unit-cost grid. The planner keeps its own copy of the wall bitmap plus g/rhs values and a
+// priority queue between calls. After a batch of cells is blocked or unblocked, only the cells
+// whose distance to the goal actually changed are taken off the queue again, instead of
+// searching the whole grid from scratch. Searching from the goal also lets the start move
+// (a robot walking its path) without discarding the search state.
+
+// Work done by the planner since it was initialised
+struct dstar_stats {
+    long long pops;       // Cells taken off the queue
+    long long pushes;     // Queue inserts and key updates
+    long long updates;    // rhs recomputations (cells touched)
+};
+
+// One cell of a batch update: blocked = true adds a wall, false removes it
+struct dstar_change {
+    int cell;             // Linear bitmap index
+    bool blocked;
+};
+
+struct dstar_planner {
+    struct maze_bitmap walls;    // Planner's own sealed wall bitmap, changed by dstar_update
+    int start, goal;
+    int last;                    // Start when km was last adjusted
+    int km;                      // Key offset accumulated by start moves
+    int* g;                      // Distance to the goal as of the last expansion
+    int* rhs;                    // One-step lookahead of g
+    long long* key;              // Queue key of each queued cell
+    int* pos;                    // Heap slot of each cell (-1 when not queued)
+    int* heap;
+    int size;
+    struct dstar_stats stats;
+};
+
+// Copy walls and plan from start to goal (linear bitmap indices). Returns the path length in
+// moves, or -1 if the goal is unreachable.
+int dstar_init(struct dstar_planner* planner, const struct maze_bitmap* walls, int start, int goal);
+void dstar_free(struct dstar_planner* planner);
+
+// Apply a batch of wall changes and repair the plan. Changes to the start, the goal, cells
+// outside the maze or cells already in the requested state are ignored. Returns the new path
+// length, or -1 if the goal is no longer reachable.
+int dstar_update(struct dstar_planner* planner, const struct dstar_change* changes, int count);
+
+// Move the start (e.g. one step along the path) and repair the plan. Returns the new length.
+int dstar_move_start(struct dstar_planner* planner, int start);
+
+// Set every cell of the current path in path (start included, goal excluded), like
+// dfs_iterative. Returns the path length in moves, or -1 if there is none.
+int dstar_path(const struct dstar_planner* planner, struct maze_bitmap* path);
+
+#endif
@@ -92,24 +92,76 @@ char stop_program() {
 /*                   MAIN AND SOLVER FUNCTIONS                       */
 /* ================================================================= */
 
-/* Recursively solve the maze */
+/* One frame of the solver's explicit stack: a cell and the next way to try from it */
+typedef struct {
+    int cell;           /* x * columns + y */
+    unsigned char next; /* index into the array filled by possibilities() */
+} Frame;
+
+/* Cells entered by solve(), read by maze_bench */
+long long solve_expansions = 0;
+
+/* Solve the maze depth-first with a growable explicit stack instead of recursion, */
+/* so long corridors cannot overflow the thread stack */
 Coordinate solve(Coordinate current, char** maze, int lines, int columns) {
     if (current.x == -1) return current;
     if (maze[current.x][current.y] == 'O') return new_coordinate(-2, -2);
+
+    int size = 0, capacity = lines + columns;
+    Frame* stack = (Frame*)malloc(sizeof(Frame) * capacity);
+    if (stack == NULL) {
+        printf("\nCould not allocate the solver stack.\n");
+        exit(1);
+    }
+
     maze[current.x][current.y] = '*';
+    solve_expansions++;
+    stack[size].cell = current.x * columns + current.y;
+    stack[size].next = 0;
+    size++;
+
+    while (size > 0) {
+        Frame* top = &stack[size - 1];
+        Coordinate cell = new_coordinate(top->cell / columns, top->cell % columns);
+
+        if (top->next == 4) {
+            maze[cell.x][cell.y] = ' '; /* backtrack */
+            size--;
+            continue;
+        }
+
+        Coordinate poss[4];
+        possibilities(cell, maze, poss, lines, columns);
+        Coordinate next = poss[top->next++];
+        if (next.x == -1) continue;
 
-    Coordinate poss[4], answer;
-    possibilities(current, maze, poss, lines, columns);
+        if (maze[next.x][next.y] == 'O') {
+            free(stack);
+            return new_coordinate(-2, -2);
+        }
 
-    for (int i = 0; i < 4; i++) {
-        answer = solve(poss[i], maze, lines, columns);
-        if (answer.x == -2) return answer;
+        if (size == capacity) {
+            capacity *= 2;
+            Frame* grown = (Frame*)realloc(stack, sizeof(Frame) * capacity);
+            if (grown == NULL) {
+                printf("\nCould not grow the solver stack.\n");
+                exit(1);
+            }
+            stack = grown;
+        }
+        maze[next.x][next.y] = '*';
+        solve_expansions++;
+        stack[size].cell = next.x * columns + next.y;
+        stack[size].next = 0;
+        size++;
     }
 
-    maze[current.x][current.y] = ' '; // backtrack
+    free(stack);
     return current;
 }
 
+/* maze_bench includes this file with GITCODE_NO_MAIN defined to call solve() directly */
+#ifndef GITCODE_NO_MAIN
 int main(void) {
     char save, pathToFile[256];
     char** maze;
@@ -189,3 +241,4 @@ int main(void) {
 
     return 0;
 }
+#endif
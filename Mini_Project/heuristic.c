@@ -0,0 +1,246 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "heuristic.h"
+#include "maze_core.h"
+#include "maze_io.h"
+
+void setHeuristic(struct Heuristic *h, enum HeuristicKind kind, int stride, int goal, const struct Landmarks *landmarks) {
+    h->kind = kind;
+    h->stride = stride;
+    h->goalRow = goal / stride;
+    h->goalCol = goal % stride;
+    h->landmarks = landmarks;
+    if (HEURISTIC_KIND(h) == HEURISTIC_ALT) {
+        if (!landmarks) {
+            printf("Error: The ALT heuristic needs landmark tables.\n");
+            exit(EXIT_FAILURE);
+        }
+        for (int l = 0; l < landmarks->count; l++) {
+            h->goalDist[l] = landmarks->dist[(size_t)goal * landmarks->count + l];
+        }
+    }
+}
+
+const char *heuristicKindName(enum HeuristicKind kind) {
+    return kind == HEURISTIC_ZERO ? "zero" : kind == HEURISTIC_ALT ? "alt" : "manhattan";
+}
+
+bool parseHeuristicKind(const char *name, enum HeuristicKind *kind) {
+    if (strcmp(name, "manhattan") == 0) {
+        *kind = HEURISTIC_MANHATTAN;
+    } else if (strcmp(name, "zero") == 0 || strcmp(name, "dijkstra") == 0) {
+        *kind = HEURISTIC_ZERO;
+    } else if (strcmp(name, "alt") == 0) {
+        *kind = HEURISTIC_ALT;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Breadth-first distances from source into dist (-1 where unreachable); queue holds numCells ints
+static void bfsDistances(const struct maze_bitmap *walls, int source, int *dist, int *queue) {
+    int numCells = walls->rows * walls->stride;
+    const int offsets[4] = { -walls->stride, walls->stride, -1, 1 };
+    for (int i = 0; i < numCells; i++) {
+        dist[i] = -1;
+    }
+    int head = 0, tail = 0;
+    dist[source] = 0;
+    queue[tail++] = source;
+    while (head < tail) {
+        int cell = queue[head++];
+        for (int d = 0; d < 4; d++) {
+            int next = cell + offsets[d];
+            if (!maze_bit_test(walls, next) && dist[next] < 0) {
+                dist[next] = dist[cell] + 1;
+                queue[tail++] = next;
+            }
+        }
+    }
+}
+
+static void allocLandmarks(struct Landmarks *lm) {
+    size_t numCells = (size_t)lm->rows * lm->stride;
+    lm->cell = (int *)malloc(lm->count * sizeof(int));
+    lm->dist = (int *)malloc(numCells * lm->count * sizeof(int));
+    if (!lm->cell || !lm->dist) {
+        printf("Error: Cannot allocate %d landmark tables.\n", lm->count);
+        exit(EXIT_FAILURE);
+    }
+}
+
+void buildLandmarks(struct Landmarks *lm, const struct maze_bitmap *walls, int count) {
+    memset(lm, 0, sizeof(*lm));
+    lm->rows = walls->rows;
+    lm->cols = walls->cols;
+    lm->stride = walls->stride;
+    lm->count = count < 1 ? 1 : count > ALT_MAX_LANDMARKS ? ALT_MAX_LANDMARKS : count;
+    allocLandmarks(lm);
+    int numCells = walls->rows * walls->stride;
+
+    int *dist = (int *)malloc(numCells * sizeof(int));
+    int *queue = (int *)malloc(numCells * sizeof(int));
+    int *nearest = (int *)malloc(numCells * sizeof(int)); // Distance to the closest landmark so far
+    if (!dist || !queue || !nearest) {
+        printf("Error: Cannot allocate landmark search state.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // Seed: the first open cell; the first landmark is the cell farthest from it
+    int seed = -1;
+    for (int i = 0; i < walls->rows && seed < 0; i++) {
+        for (int j = 0; j < walls->cols; j++) {
+            if (!maze_bit_test(walls, maze_bit_index(walls, i, j))) {
+                seed = maze_bit_index(walls, i, j);
+                break;
+            }
+        }
+    }
+    if (seed < 0) {
+        for (int l = 0; l < lm->count; l++) {
+            lm->cell[l] = -1;
+        }
+        memset(lm->dist, -1, (size_t)numCells * lm->count * sizeof(int));
+    } else {
+        bfsDistances(walls, seed, nearest, queue);
+        for (int l = 0; l < lm->count; l++) {
+            // Next landmark: the reachable cell farthest from every landmark chosen so far
+            int pick = seed;
+            for (int i = 0; i < numCells; i++) {
+                if (nearest[i] > nearest[pick]) {
+                    pick = i;
+                }
+            }
+            lm->cell[l] = pick;
+            bfsDistances(walls, pick, dist, queue);
+            for (int i = 0; i < numCells; i++) {
+                lm->dist[(size_t)i * lm->count + l] = dist[i];
+                if (l == 0 || (dist[i] >= 0 && dist[i] < nearest[i])) {
+                    nearest[i] = dist[i];
+                }
+            }
+        }
+    }
+    free(dist);
+    free(queue);
+    free(nearest);
+}
+
+void freeLandmarks(struct Landmarks *lm) {
+    free(lm->cell);
+    free(lm->dist);
+    memset(lm, 0, sizeof(*lm));
+}
+
+void landmarksPath(const char *mazePath, int count, char *out, size_t size) {
+    char suffix[32];
+    snprintf(suffix, sizeof(suffix), ".l%d.alt", count);
+    maze_sidecar_path(mazePath, suffix, out, size);
+}
+
+// On-disk header; the landmark cells and the distance table follow
+struct altHeader {
+    char magic[4];
+    uint32_t version;
+    int32_t rows, cols, stride;
+    int32_t count;
+    uint64_t sourceChecksum;
+    uint64_t sourceSize;
+};
+
+int saveLandmarks(const struct Landmarks *lm, const char *path) {
+    struct altHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, ALT_MAGIC, 4);
+    header.version = ALT_VERSION;
+    header.rows = lm->rows;
+    header.cols = lm->cols;
+    header.stride = lm->stride;
+    header.count = lm->count;
+    header.sourceChecksum = lm->sourceChecksum;
+    header.sourceSize = lm->sourceSize;
+
+    struct maze_writer writer;
+    if (maze_writer_open(&writer, path) < 0) {
+        return -1;
+    }
+    maze_writer_write(&writer, (const char *)&header, sizeof(header));
+    maze_writer_write(&writer, (const char *)lm->cell, lm->count * sizeof(int32_t));
+    maze_writer_write(&writer, (const char *)lm->dist, (size_t)lm->rows * lm->stride * lm->count * sizeof(int32_t));
+    return maze_writer_close(&writer);
+}
+
+int loadLandmarks(struct Landmarks *lm, const char *path, int count, uint64_t sourceChecksum, uint64_t sourceSize) {
+    memset(lm, 0, sizeof(*lm));
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        return -1;
+    }
+
+    struct altHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 || memcmp(header.magic, ALT_MAGIC, 4) != 0 ||
+        header.version != ALT_VERSION) {
+        printf("Error: %s is not a landmark file.\n", path);
+        fclose(file);
+        return -1;
+    }
+    if (header.sourceChecksum != sourceChecksum || header.sourceSize != sourceSize || header.count != count) {
+        printf("Note: %s was built from a different maze; rebuilding.\n", path);
+        fclose(file);
+        return -1;
+    }
+    if (header.rows < 1 || header.cols < 1 || header.stride != maze_stride_for(header.cols) ||
+        (long long)header.rows * header.stride > INT_MAX || count < 1 || count > ALT_MAX_LANDMARKS) {
+        printf("Error: %s has an invalid header.\n", path);
+        fclose(file);
+        return -1;
+    }
+
+    lm->rows = header.rows;
+    lm->cols = header.cols;
+    lm->stride = header.stride;
+    lm->count = count;
+    lm->sourceChecksum = sourceChecksum;
+    lm->sourceSize = sourceSize;
+    allocLandmarks(lm);
+    size_t entries = (size_t)lm->rows * lm->stride * count;
+    int ok = fread(lm->cell, sizeof(int32_t), count, file) == (size_t)count &&
+             fread(lm->dist, sizeof(int32_t), entries, file) == entries;
+    fclose(file);
+
+    // Distances outside [-1, cells) would break admissibility
+    int numCells = lm->rows * lm->stride;
+    for (size_t i = 0; ok && i < entries; i++) {
+        ok = lm->dist[i] >= -1 && lm->dist[i] < numCells;
+    }
+    if (!ok) {
+        printf("Error: %s is truncated or corrupt.\n", path);
+        freeLandmarks(lm);
+        return -1;
+    }
+    return 0;
+}
+
+int prepareLandmarks(struct Landmarks *lm, const char *mazePath, const struct maze_bitmap *walls, int count) {
+    uint64_t checksum, size;
+    if (maze_file_checksum(mazePath, &checksum, &size) < 0) {
+        return -1;
+    }
+
+    char path[4096];
+    landmarksPath(mazePath, count, path, sizeof(path));
+    if (loadLandmarks(lm, path, count, checksum, size) == 0 && lm->rows == walls->rows && lm->cols == walls->cols) {
+        return 0;
+    }
+    if (lm->dist) {
+        freeLandmarks(lm);
+    }
+    buildLandmarks(lm, walls, count);
+    lm->sourceChecksum = checksum;
+    lm->sourceSize = size;
+    saveLandmarks(lm, path);
+    return 0;
+}
@@ -0,0 +1,110 @@
+#ifndef HEURISTIC_H
+#define HEURISTIC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "maze_bits.h"
+
+// Admissible A* heuristics for the 4-connected unit-cost grid. Cells are linear bitmap indices.
+//   manhattan: |dr| + |dc|, exact on an open grid
+//   zero:      0, which turns A* into Dijkstra
+//   alt:       landmarks + triangle inequality: max over landmarks L of |d(L, goal) - d(L, cell)|,
+//              never below Manhattan since the larger of two admissible bounds is taken
+// The heuristic is chosen at run time, or fixed at build time with -DHEURISTIC=HEURISTIC_ZERO
+// (or _MANHATTAN, _ALT) so the switch in heuristicValue folds away. A fixed build ignores the
+// run-time choice, and a fixed ALT build sets up its landmark tables on its own.
+
+#define ALT_MAGIC "ALT1"
+#define ALT_VERSION 1
+#define ALT_DEFAULT_LANDMARKS 8
+#define ALT_MAX_LANDMARKS 16
+
+enum HeuristicKind {
+    HEURISTIC_MANHATTAN,
+    HEURISTIC_ZERO,
+    HEURISTIC_ALT
+};
+
+// BFS distances from a few landmark cells, chosen far apart (farthest-point selection)
+struct Landmarks {
+    int rows, cols, stride;
+    int count;
+    int *cell;                 // Cell of each landmark
+    int *dist;                 // dist[cell * count + l]: moves from landmark l, -1 if unreachable
+    uint64_t sourceChecksum;   // Checksum of the maze file the tables were built from
+    uint64_t sourceSize;
+};
+
+// A heuristic bound to one goal
+struct Heuristic {
+    enum HeuristicKind kind;
+    int stride;
+    int goalRow, goalCol;
+    const struct Landmarks *landmarks;   // HEURISTIC_ALT only
+    int goalDist[ALT_MAX_LANDMARKS];     // Distance of the goal from each landmark
+};
+
+#ifdef HEURISTIC
+#define HEURISTIC_KIND(h) (HEURISTIC)
+#define HEURISTIC_DEFAULT (HEURISTIC)
+#else
+#define HEURISTIC_KIND(h) ((h)->kind)
+#define HEURISTIC_DEFAULT HEURISTIC_MANHATTAN
+#endif
+
+// True if a search asked to use kind will run ALT and so needs landmark tables
+static inline bool heuristicNeedsLandmarks(enum HeuristicKind kind) {
+#ifdef HEURISTIC
+    (void)kind;
+    return HEURISTIC == HEURISTIC_ALT;
+#else
+    return kind == HEURISTIC_ALT;
+#endif
+}
+
+// Bind a heuristic of the given kind to goal; landmarks are required for HEURISTIC_ALT
+void setHeuristic(struct Heuristic *h, enum HeuristicKind kind, int stride, int goal, const struct Landmarks *landmarks);
+
+static inline int heuristicValue(const struct Heuristic *h, int cell) {
+    switch (HEURISTIC_KIND(h)) {
+    case HEURISTIC_ZERO:
+        return 0;
+    case HEURISTIC_ALT: {
+        int best = abs(cell / h->stride - h->goalRow) + abs(cell % h->stride - h->goalCol);
+        const struct Landmarks *lm = h->landmarks;
+        const int *d = lm->dist + (size_t)cell * lm->count;
+        for (int l = 0; l < lm->count; l++) {
+            if (d[l] >= 0 && h->goalDist[l] >= 0) {
+                int bound = abs(h->goalDist[l] - d[l]);
+                best = bound > best ? bound : best;
+            }
+        }
+        return best;
+    }
+    default:
+        return abs(cell / h->stride - h->goalRow) + abs(cell % h->stride - h->goalCol);
+    }
+}
+
+const char *heuristicKindName(enum HeuristicKind kind);
+bool parseHeuristicKind(const char *name, enum HeuristicKind *kind);
+
+// Pick count landmarks and fill their BFS distance tables from a sealed wall bitmap
+void buildLandmarks(struct Landmarks *lm, const struct maze_bitmap *walls, int count);
+void freeLandmarks(struct Landmarks *lm);
+
+// Save/load the tables next to the maze. Load fails (returns -1) if the file is missing,
+// malformed, built from a different maze file or with another landmark count.
+int saveLandmarks(const struct Landmarks *lm, const char *path);
+int loadLandmarks(struct Landmarks *lm, const char *path, int count, uint64_t sourceChecksum, uint64_t sourceSize);
+
+// Derive the landmark file name from the maze file name: maze.txt -> maze.txt.l8.alt
+void landmarksPath(const char *mazePath, int count, char *out, size_t size);
+
+// Load the landmarks cached for mazePath, or build and save them. Returns -1 if the maze file
+// cannot be read.
+int prepareLandmarks(struct Landmarks *lm, const char *mazePath, const struct maze_bitmap *walls, int count);
+
+#endif
@@ -0,0 +1,554 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "hpa.h"
+#include "search_stats.h"
+#include "maze_io.h"
+#include "open_list.h"
+
+#define HPA_SHORT_RUN 6 // Entrance runs shorter than this get one transition, longer ones two
+
+// Growable list of ints
+struct int_list {
+    int* items;
+    int size;
+    int capacity;
+};
+
+static void list_push(struct int_list* list, int value) {
+    if (list->size == list->capacity) {
+        list->capacity = list->capacity ? list->capacity * 2 : 1024;
+        list->items = (int*)realloc(list->items, list->capacity * sizeof(int));
+        if (!list->items) {
+            printf("Error: Cannot grow the HPA* lists.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    list->items[list->size++] = value;
+}
+
+// Scratch space for a BFS confined to one cluster, indexed by cell within the cluster
+struct cluster_search {
+    int row0, col0, row1, col1;   // Cluster bounds, [row0, row1) x [col0, col1)
+    int* dist;                    // Moves from the origin, -1 if unreached
+    int* queue;
+};
+
+static void search_alloc(struct cluster_search* search, int cluster) {
+    search->dist = (int*)malloc((size_t)cluster * cluster * sizeof(int));
+    search->queue = (int*)malloc((size_t)cluster * cluster * sizeof(int));
+    if (!search->dist || !search->queue) {
+        printf("Error: Cannot allocate cluster search space.\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+static void search_free(struct cluster_search* search) {
+    free(search->dist);
+    free(search->queue);
+}
+
+static int cluster_of(const struct hpa_graph* graph, int cell) {
+    return (cell / graph->stride / graph->cluster) * graph->cluster_cols + (cell % graph->stride) / graph->cluster;
+}
+
+// Index of a cell inside the search's cluster, or -1 if it lies outside
+static int local_index(const struct hpa_graph* graph, const struct cluster_search* search, int cell) {
+    int row = cell / graph->stride, col = cell % graph->stride;
+    if (row < search->row0 || row >= search->row1 || col < search->col0 || col >= search->col1) {
+        return -1;
+    }
+    return (row - search->row0) * graph->cluster + (col - search->col0);
+}
+
+// BFS from cell without leaving its cluster. Returns the number of cells visited.
+static long long cluster_bfs(const struct hpa_graph* graph, const struct maze_bitmap* walls, int cell,
+                             struct cluster_search* search) {
+    int k = cluster_of(graph, cell);
+    search->row0 = (k / graph->cluster_cols) * graph->cluster;
+    search->col0 = (k % graph->cluster_cols) * graph->cluster;
+    search->row1 = search->row0 + graph->cluster < graph->rows ? search->row0 + graph->cluster : graph->rows;
+    search->col1 = search->col0 + graph->cluster < graph->cols ? search->col0 + graph->cluster : graph->cols;
+    for (int i = 0; i < graph->cluster * graph->cluster; i++) {
+        search->dist[i] = -1;
+    }
+
+    const int offsets[4] = { -graph->stride, graph->stride, -1, 1 };
+    int head = 0, tail = 0;
+    search->dist[local_index(graph, search, cell)] = 0;
+    search->queue[tail++] = cell;
+    while (head < tail) {
+        int current = search->queue[head++];
+        int next_dist = search->dist[local_index(graph, search, current)] + 1;
+        for (int d = 0; d < 4; d++) {
+            int next = current + offsets[d];
+            int local = local_index(graph, search, next);
+            if (local >= 0 && search->dist[local] < 0 && !maze_bit_test(walls, next)) {
+                search->dist[local] = next_dist;
+                search->queue[tail++] = next;
+            }
+        }
+    }
+    return tail;
+}
+
+// Distance from the last BFS origin to cell, -1 if unreachable inside the cluster
+static int search_dist(const struct hpa_graph* graph, const struct cluster_search* search, int cell) {
+    int local = local_index(graph, search, cell);
+    return local < 0 ? -1 : search->dist[local];
+}
+
+// Node id of a node cell (node_cell is sorted), or -1
+static int node_id(const struct hpa_graph* graph, int cell) {
+    int lo = 0, hi = graph->num_nodes - 1;
+    while (lo <= hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (graph->node_cell[mid] < cell) {
+            lo = mid + 1;
+        } else if (graph->node_cell[mid] > cell) {
+            hi = mid - 1;
+        } else {
+            return mid;
+        }
+    }
+    return -1;
+}
+
+static int compare_ints(const void* a, const void* b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+// Group the nodes by cluster (they stay sorted by cell within each cluster)
+static void index_clusters(struct hpa_graph* graph) {
+    int clusters = graph->cluster_rows * graph->cluster_cols;
+    graph->cluster_first = (int*)calloc(clusters + 1, sizeof(int));
+    graph->cluster_nodes = (int*)malloc((graph->num_nodes + 1) * sizeof(int));
+    if (!graph->cluster_first || !graph->cluster_nodes) {
+        printf("Error: Cannot allocate the cluster index.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int n = 0; n < graph->num_nodes; n++) {
+        graph->cluster_first[cluster_of(graph, graph->node_cell[n]) + 1]++;
+    }
+    for (int k = 0; k < clusters; k++) {
+        graph->cluster_first[k + 1] += graph->cluster_first[k];
+    }
+    int* fill = (int*)malloc((clusters + 1) * sizeof(int));
+    if (!fill) {
+        printf("Error: Cannot allocate the cluster index.\n");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(fill, graph->cluster_first, clusters * sizeof(int));
+    for (int n = 0; n < graph->num_nodes; n++) {
+        graph->cluster_nodes[fill[cluster_of(graph, graph->node_cell[n])]++] = n;
+    }
+    free(fill);
+}
+
+// Turn one run of open pairs across a border into transitions; a and b step along the run
+static void add_run(struct int_list* pairs, int first_a, int first_b, int length, int step) {
+    if (length < HPA_SHORT_RUN) {
+        int middle = (length - 1) / 2;
+        list_push(pairs, first_a + middle * step);
+        list_push(pairs, first_b + middle * step);
+    } else {
+        list_push(pairs, first_a);
+        list_push(pairs, first_b);
+        list_push(pairs, first_a + (length - 1) * step);
+        list_push(pairs, first_b + (length - 1) * step);
+    }
+}
+
+// Scan the cell pairs (a, a + across) for a = first + i * step, i < count, and add each open run
+static void scan_border(const struct maze_bitmap* walls, struct int_list* pairs, int first, int across, int step, int count) {
+    int run = -1;
+    for (int i = 0; i <= count; i++) {
+        int a = first + i * step;
+        int open = i < count && !maze_bit_test(walls, a) && !maze_bit_test(walls, a + across);
+        if (open && run < 0) {
+            run = i;
+        } else if (!open && run >= 0) {
+            add_run(pairs, first + run * step, first + run * step + across, i - run, step);
+            run = -1;
+        }
+    }
+}
+
+void hpa_build(struct hpa_graph* graph, const struct maze_bitmap* walls, int cluster) {
+    memset(graph, 0, sizeof(*graph));
+    graph->rows = walls->rows;
+    graph->cols = walls->cols;
+    graph->stride = walls->stride;
+    graph->cluster = cluster;
+    graph->cluster_rows = (walls->rows + cluster - 1) / cluster;
+    graph->cluster_cols = (walls->cols + cluster - 1) / cluster;
+
+    // Entrances: pairs of cells on both sides of every border, split at cluster corners
+    struct int_list pairs = { NULL, 0, 0 };
+    for (int row0 = 0; row0 < walls->rows; row0 += cluster) {
+        int height = row0 + cluster < walls->rows ? cluster : walls->rows - row0;
+        for (int col = cluster; col < walls->cols; col += cluster) {
+            scan_border(walls, &pairs, maze_bit_index(walls, row0, col - 1), 1, walls->stride, height);
+        }
+    }
+    for (int col0 = 0; col0 < walls->cols; col0 += cluster) {
+        int width = col0 + cluster < walls->cols ? cluster : walls->cols - col0;
+        for (int row = cluster; row < walls->rows; row += cluster) {
+            scan_border(walls, &pairs, maze_bit_index(walls, row - 1, col0), walls->stride, 1, width);
+        }
+    }
+
+    // Nodes: the distinct entrance cells, sorted
+    int* cells = (int*)malloc((pairs.size + 1) * sizeof(int));
+    if (!cells) {
+        printf("Error: Cannot allocate HPA* nodes.\n");
+        exit(EXIT_FAILURE);
+    }
+    if (pairs.size) {
+        memcpy(cells, pairs.items, pairs.size * sizeof(int));
+    }
+    qsort(cells, pairs.size, sizeof(int), compare_ints);
+    int unique = 0;
+    for (int i = 0; i < pairs.size; i++) {
+        if (unique == 0 || cells[i] != cells[unique - 1]) {
+            cells[unique++] = cells[i];
+        }
+    }
+    graph->node_cell = cells;
+    graph->num_nodes = unique;
+    index_clusters(graph);
+
+    // Directed edges: both directions of every entrance, then all reachable pairs inside clusters
+    struct int_list from = { NULL, 0, 0 }, to = { NULL, 0, 0 }, cost = { NULL, 0, 0 };
+    for (int i = 0; i < pairs.size; i += 2) {
+        int a = node_id(graph, pairs.items[i]), b = node_id(graph, pairs.items[i + 1]);
+        list_push(&from, a); list_push(&to, b); list_push(&cost, 1);
+        list_push(&from, b); list_push(&to, a); list_push(&cost, 1);
+    }
+    free(pairs.items);
+
+    struct cluster_search search;
+    search_alloc(&search, cluster);
+    for (int k = 0; k < graph->cluster_rows * graph->cluster_cols; k++) {
+        for (int i = graph->cluster_first[k]; i < graph->cluster_first[k + 1]; i++) {
+            int a = graph->cluster_nodes[i];
+            cluster_bfs(graph, walls, graph->node_cell[a], &search);
+            for (int j = graph->cluster_first[k]; j < graph->cluster_first[k + 1]; j++) {
+                int b = graph->cluster_nodes[j];
+                int d = search_dist(graph, &search, graph->node_cell[b]);
+                if (b != a && d > 0) {
+                    list_push(&from, a); list_push(&to, b); list_push(&cost, d);
+                }
+            }
+        }
+    }
+    search_free(&search);
+
+    // Compressed rows by source node
+    graph->num_edges = from.size;
+    graph->first_edge = (int*)calloc(graph->num_nodes + 1, sizeof(int));
+    graph->edge_target = (int*)malloc((from.size + 1) * sizeof(int));
+    graph->edge_cost = (int*)malloc((from.size + 1) * sizeof(int));
+    int* fill = (int*)malloc((graph->num_nodes + 1) * sizeof(int));
+    if (!graph->first_edge || !graph->edge_target || !graph->edge_cost || !fill) {
+        printf("Error: Cannot allocate HPA* edges.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int e = 0; e < from.size; e++) {
+        graph->first_edge[from.items[e] + 1]++;
+    }
+    for (int n = 0; n < graph->num_nodes; n++) {
+        graph->first_edge[n + 1] += graph->first_edge[n];
+    }
+    memcpy(fill, graph->first_edge, graph->num_nodes * sizeof(int));
+    for (int e = 0; e < from.size; e++) {
+        int slot = fill[from.items[e]]++;
+        graph->edge_target[slot] = to.items[e];
+        graph->edge_cost[slot] = cost.items[e];
+    }
+    free(fill);
+    free(from.items);
+    free(to.items);
+    free(cost.items);
+}
+
+void hpa_free(struct hpa_graph* graph) {
+    free(graph->node_cell);
+    free(graph->first_edge);
+    free(graph->edge_target);
+    free(graph->edge_cost);
+    free(graph->cluster_first);
+    free(graph->cluster_nodes);
+    memset(graph, 0, sizeof(*graph));
+}
+
+void hpa_cache_path(const char* maze_path, int cluster, char* out, size_t size) {
+    char suffix[32];
+    snprintf(suffix, sizeof(suffix), ".c%d.hpa", cluster);
+    maze_sidecar_path(maze_path, suffix, out, size);
+}
+
+// On-disk header; node_cell, first_edge, edge_target and edge_cost follow
+struct hpa_header {
+    char magic[4];
+    uint32_t version;
+    int32_t rows, cols, stride, cluster;
+    int32_t num_nodes, num_edges;
+    uint64_t source_checksum;
+    uint64_t source_size;
+};
+
+int hpa_save(const struct hpa_graph* graph, const char* path) {
+    struct hpa_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, HPA_MAGIC, 4);
+    header.version = HPA_VERSION;
+    header.rows = graph->rows;
+    header.cols = graph->cols;
+    header.stride = graph->stride;
+    header.cluster = graph->cluster;
+    header.num_nodes = graph->num_nodes;
+    header.num_edges = graph->num_edges;
+    header.source_checksum = graph->source_checksum;
+    header.source_size = graph->source_size;
+
+    struct maze_writer writer;
+    if (maze_writer_open(&writer, path) < 0) {
+        return -1;
+    }
+    maze_writer_write(&writer, (const char*)&header, sizeof(header));
+    maze_writer_write(&writer, (const char*)graph->node_cell, graph->num_nodes * sizeof(int32_t));
+    maze_writer_write(&writer, (const char*)graph->first_edge, (graph->num_nodes + 1) * sizeof(int32_t));
+    maze_writer_write(&writer, (const char*)graph->edge_target, graph->num_edges * sizeof(int32_t));
+    maze_writer_write(&writer, (const char*)graph->edge_cost, graph->num_edges * sizeof(int32_t));
+    return maze_writer_close(&writer);
+}
+
+// Check the arrays of a loaded abstraction, so a corrupt file cannot send the search out of bounds
+static int graph_is_consistent(const struct hpa_graph* graph) {
+    int cells = graph->rows * graph->stride;
+    for (int n = 0; n < graph->num_nodes; n++) {
+        int cell = graph->node_cell[n];
+        if (cell < 0 || cell >= cells || cell % graph->stride >= graph->cols ||
+            (n > 0 && cell <= graph->node_cell[n - 1]) || graph->first_edge[n] > graph->first_edge[n + 1]) {
+            return 0;
+        }
+    }
+    if (graph->first_edge[0] != 0 || graph->first_edge[graph->num_nodes] != graph->num_edges) {
+        return 0;
+    }
+    for (int e = 0; e < graph->num_edges; e++) {
+        if (graph->edge_target[e] < 0 || graph->edge_target[e] >= graph->num_nodes || graph->edge_cost[e] < 1) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int hpa_load(struct hpa_graph* graph, const char* path, int cluster, uint64_t source_checksum, uint64_t source_size) {
+    memset(graph, 0, sizeof(*graph));
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return -1;
+    }
+
+    struct hpa_header header;
+    if (fread(&header, sizeof(header), 1, file) != 1 || memcmp(header.magic, HPA_MAGIC, 4) != 0 ||
+        header.version != HPA_VERSION) {
+        printf("Error: %s is not an HPA* cache file.\n", path);
+        fclose(file);
+        return -1;
+    }
+    if (header.source_checksum != source_checksum || header.source_size != source_size || header.cluster != cluster) {
+        printf("Note: %s was built from a different maze; rebuilding.\n", path);
+        fclose(file);
+        return -1;
+    }
+    if (header.rows < 1 || header.cols < 1 || header.stride != maze_stride_for(header.cols) ||
+        (long long)header.rows * header.stride > INT_MAX || header.cluster < 2 ||
+        header.num_nodes < 0 || header.num_edges < 0) {
+        printf("Error: %s has an invalid header.\n", path);
+        fclose(file);
+        return -1;
+    }
+
+    graph->rows = header.rows;
+    graph->cols = header.cols;
+    graph->stride = header.stride;
+    graph->cluster = header.cluster;
+    graph->cluster_rows = (header.rows + header.cluster - 1) / header.cluster;
+    graph->cluster_cols = (header.cols + header.cluster - 1) / header.cluster;
+    graph->num_nodes = header.num_nodes;
+    graph->num_edges = header.num_edges;
+    graph->source_checksum = header.source_checksum;
+    graph->source_size = header.source_size;
+    size_t nodes = graph->num_nodes, edges = graph->num_edges;
+    graph->node_cell = (int*)malloc((nodes + 1) * sizeof(int));
+    graph->first_edge = (int*)malloc((nodes + 1) * sizeof(int));
+    graph->edge_target = (int*)malloc((edges + 1) * sizeof(int));
+    graph->edge_cost = (int*)malloc((edges + 1) * sizeof(int));
+    if (!graph->node_cell || !graph->first_edge || !graph->edge_target || !graph->edge_cost) {
+        printf("Error: Cannot allocate the HPA* graph.\n");
+        exit(EXIT_FAILURE);
+    }
+    int ok = fread(graph->node_cell, sizeof(int32_t), nodes, file) == nodes &&
+             fread(graph->first_edge, sizeof(int32_t), nodes + 1, file) == nodes + 1 &&
+             fread(graph->edge_target, sizeof(int32_t), edges, file) == edges &&
+             fread(graph->edge_cost, sizeof(int32_t), edges, file) == edges;
+    fclose(file);
+    if (!ok || !graph_is_consistent(graph)) {
+        printf("Error: %s is truncated or corrupt.\n", path);
+        hpa_free(graph);
+        return -1;
+    }
+    index_clusters(graph);
+    return 0;
+}
+
+// Mark the cells of the in-cluster shortest path from a to b (a included, b excluded)
+static long long refine(const struct hpa_graph* graph, const struct maze_bitmap* walls, int a, int b,
+                        struct cluster_search* search, struct maze_bitmap* path) {
+    const int offsets[4] = { -graph->stride, graph->stride, -1, 1 };
+    long long visited = cluster_bfs(graph, walls, a, search);
+    int cell = b;
+    while (cell != a) {
+        int d = search_dist(graph, search, cell);
+        for (int k = 0; k < 4; k++) {
+            if (search_dist(graph, search, cell + offsets[k]) == d - 1) {
+                cell += offsets[k];
+                break;
+            }
+        }
+        maze_bit_set(path, cell);
+    }
+    return visited;
+}
+
+int hpa_solve(const struct hpa_graph* graph, const struct maze_bitmap* walls, int start, int goal,
+              struct maze_bitmap* path, struct hpa_stats* stats) {
+    struct hpa_stats local = { 0, 0 };
+    if (stats) {
+        *stats = local;
+    }
+    if (maze_bit_test(walls, start) || maze_bit_test(walls, goal)) {
+        return -1;
+    }
+    if (start == goal) {
+        return 0;
+    }
+    STATS_DECLARE(counters, "hpa");
+
+    // Slots: the abstract nodes, then start and goal
+    int slots = graph->num_nodes + 2, start_slot = graph->num_nodes, goal_slot = graph->num_nodes + 1;
+    int* g = (int*)malloc(slots * sizeof(int));
+    int* parent = (int*)malloc(slots * sizeof(int));
+    if (!g || !parent) {
+        printf("Error: Cannot allocate HPA* search state.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int n = 0; n < slots; n++) {
+        g[n] = INT_MAX;
+    }
+    struct OpenList* open = createOpenList(slots, OPEN_LIST_HEAP);
+    int goal_row = goal / graph->stride, goal_col = goal % graph->stride;
+    int goal_cluster = cluster_of(graph, goal);
+
+    // Distances from the goal to the nodes of its cluster stay in goal_search for the whole query
+    struct cluster_search goal_search, search;
+    search_alloc(&goal_search, graph->cluster);
+    search_alloc(&search, graph->cluster);
+    local.cells_visited += cluster_bfs(graph, walls, goal, &goal_search);
+
+    // Start: edges to the nodes of its cluster, and straight to the goal if it is in the same one
+    local.cells_visited += cluster_bfs(graph, walls, start, &search);
+    int start_cluster = cluster_of(graph, start);
+    g[start_slot] = 0;
+    parent[start_slot] = -1;
+    for (int i = graph->cluster_first[start_cluster]; i < graph->cluster_first[start_cluster + 1]; i++) {
+        int n = graph->cluster_nodes[i];
+        int d = search_dist(graph, &search, graph->node_cell[n]);
+        if (d >= 0) {
+            int h = abs(graph->node_cell[n] / graph->stride - goal_row) + abs(graph->node_cell[n] % graph->stride - goal_col);
+            g[n] = d;
+            parent[n] = start_slot;
+            openListPush(open, n, d + h);
+        }
+    }
+    int direct = search_dist(graph, &search, goal);
+    if (direct >= 0) {
+        g[goal_slot] = direct;
+        parent[goal_slot] = start_slot;
+        openListPush(open, goal_slot, direct);
+    }
+
+    STATS_PHASE(counters, "search");
+    int length = -1;
+    int node;
+    while ((node = openListPop(open)) != -1) {
+        local.nodes_popped++;
+        STATS_MAX(counters, peak_open, open->size + 1);
+        if (node == goal_slot) {
+            length = g[goal_slot];
+            break;
+        }
+        int cell = graph->node_cell[node];
+        if (cluster_of(graph, cell) == goal_cluster) {
+            int d = search_dist(graph, &goal_search, cell);
+            if (d >= 0 && g[node] + d < g[goal_slot]) {
+                g[goal_slot] = g[node] + d;
+                parent[goal_slot] = node;
+                openListPush(open, goal_slot, g[goal_slot]);
+            }
+        }
+        for (int e = graph->first_edge[node]; e < graph->first_edge[node + 1]; e++) {
+            int target = graph->edge_target[e];
+            int cost = g[node] + graph->edge_cost[e];
+            if (cost < g[target]) {
+                int target_cell = graph->node_cell[target];
+                int h = abs(target_cell / graph->stride - goal_row) + abs(target_cell % graph->stride - goal_col);
+                g[target] = cost;
+                parent[target] = node;
+                openListPush(open, target, cost + h);
+            }
+        }
+    }
+
+    // Refine the abstract path, one cluster-local segment at a time
+    STATS_PHASE(counters, "refine");
+    if (length >= 0) {
+        for (int n = goal_slot; n != start_slot; n = parent[n]) {
+            int to = n == goal_slot ? goal : graph->node_cell[n];
+            int from = parent[n] == start_slot ? start : graph->node_cell[parent[n]];
+            int row_gap = abs(to / graph->stride - from / graph->stride), col_gap = abs(to % graph->stride - from % graph->stride);
+            if (row_gap + col_gap == 1) {
+                maze_bit_set(path, from);
+            } else {
+                local.cells_visited += refine(graph, walls, from, to, &search, path);
+            }
+        }
+    }
+
+#ifdef MAZE_STATS
+    // Every push after a slot's first is a re-opening with a lower cost (the start slot is never pushed)
+    long long touched = 0;
+    for (int n = 0; n < slots; n++) {
+        touched += g[n] != INT_MAX && n != start_slot;
+    }
+    STATS_ADD(counters, expanded, local.nodes_popped);
+    STATS_ADD(counters, generated, open->pushes);
+    STATS_ADD(counters, reopened, open->pushes - touched);
+    STATS_ADD(counters, state_bytes, openListBytes(open) + (long long)slots * (2 * sizeof(int)) + 4LL * graph->cluster * graph->cluster * sizeof(int));
+    STATS_REPORT(counters);
+#endif
+    if (stats) {
+        *stats = local;
+    }
+    search_free(&goal_search);
+    search_free(&search);
+    freeOpenList(open);
+    free(g);
+    free(parent);
+    return length;
+}
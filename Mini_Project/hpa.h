@@ -0,0 +1,55 @@
+#ifndef HPA_H
+#define HPA_H
+
+#include <stdint.h>
+#include "maze_bits.h"
+
+#define HPA_MAGIC "HPA1"
+#define HPA_VERSION 1
+#define HPA_DEFAULT_CLUSTER 32
+
+// HPA* abstraction: the grid is cut into cluster x cluster blocks. Where two neighbouring blocks
+// share a run of open cell pairs, one pair (short runs) or the two end pairs (long runs) become
+// entrances. The abstract nodes are the entrance cells; edges join the two cells of an entrance
+// (cost 1) and every pair of nodes in the same cluster that can reach each other inside it (cost =
+// BFS distance within the cluster). Cells are linear bitmap indices (row * stride + col).
+struct hpa_graph {
+    int rows, cols, stride;
+    int cluster;                   // Cluster edge in cells
+    int cluster_rows, cluster_cols;
+    int num_nodes, num_edges;
+    int* node_cell;                // Cell of each node, in increasing (row-major) order
+    int* first_edge;               // Edges of node n are first_edge[n] .. first_edge[n + 1] - 1
+    int* edge_target;
+    int* edge_cost;
+    int* cluster_first;            // Nodes of cluster k are cluster_nodes[cluster_first[k] ..]
+    int* cluster_nodes;            // (rebuilt on load, not stored)
+    uint64_t source_checksum;      // Checksum and size of the maze file the graph was built from
+    uint64_t source_size;
+};
+
+// Statistics of one query
+struct hpa_stats {
+    long long nodes_popped;        // Abstract nodes taken off the open list
+    long long cells_visited;       // Cells visited by the in-cluster searches (attach and refine)
+};
+
+void hpa_build(struct hpa_graph* graph, const struct maze_bitmap* walls, int cluster);
+void hpa_free(struct hpa_graph* graph);
+
+// Cache file next to the maze: maze.txt with cluster 32 -> maze.txt.c32.hpa
+void hpa_cache_path(const char* maze_path, int cluster, char* out, size_t size);
+
+// Save/load the abstraction. Load fails (returns -1) if the file is missing, malformed, or was
+// built from a different maze file or cluster size. Both print a message on error.
+int hpa_save(const struct hpa_graph* graph, const char* path);
+int hpa_load(struct hpa_graph* graph, const char* path, int cluster, uint64_t source_checksum, uint64_t source_size);
+
+// Connect start and goal to the nodes of their clusters, search the abstract graph with A*,
+// then refine each abstract edge into cells with a BFS inside its cluster. The path is marked in
+// path (start included, goal excluded). Like HPA*, the result may be slightly longer than the
+// true shortest path. Returns its length in moves, or -1 if no abstract path exists.
+int hpa_solve(const struct hpa_graph* graph, const struct maze_bitmap* walls, int start, int goal,
+              struct maze_bitmap* path, struct hpa_stats* stats);
+
+#endif
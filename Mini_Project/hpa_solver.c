@@ -0,0 +1,86 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "maze_core.h"
+#include "maze_bits.h"
+#include "maze_io.h"
+#include "hpa.h"
+
+// Solve a maze with HPA*. The cluster abstraction is built once per maze file and cluster size
+// and cached next to the maze (maze.txt -> maze.c32.hpa); later runs load it and only search
+// the abstract graph plus the clusters the path goes through. The solution is written to sol.txt.
+//
+// Usage: hpa_solver [maze file] [cluster size] [start_row start_col goal_row goal_col]
+
+double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char *argv[]) {
+    const char *maze_path = argc > 1 ? argv[1] : "maze.txt";
+    int cluster = argc > 2 ? atoi(argv[2]) : HPA_DEFAULT_CLUSTER;
+    if ((argc > 3 && argc != 7) || cluster < 2 || cluster > 4096) {
+        printf("Usage: %s [maze file] [cluster size 2..4096] [start_row start_col goal_row goal_col]\n", argv[0]);
+        return 1;
+    }
+
+    struct maze_file maze;
+    if (maze_file_open(&maze, maze_path) < 0) {
+        return 1;
+    }
+    struct maze_bitmap walls;
+    maze_file_to_bitmap(&maze, &walls, 'x');
+
+    int start_row = maze.start_row, start_col = maze.start_col;
+    int goal_row = maze.goal_row, goal_col = maze.goal_col;
+    if (argc == 7) {
+        start_row = atoi(argv[3]);
+        start_col = atoi(argv[4]);
+        goal_row = atoi(argv[5]);
+        goal_col = atoi(argv[6]);
+    }
+    if (start_row < 0 || start_row >= maze.rows || start_col < 0 || start_col >= maze.cols ||
+        goal_row < 0 || goal_row >= maze.rows || goal_col < 0 || goal_col >= maze.cols) {
+        printf("Error: Start and goal must be inside the %d x %d maze.\n", maze.rows, maze.cols);
+        return 1;
+    }
+
+    // Reuse the cached abstraction when it matches this maze file and cluster size
+    char cache_path[4096];
+    hpa_cache_path(maze_path, cluster, cache_path, sizeof(cache_path));
+    uint64_t checksum = mzb_checksum(maze.data, maze.size);
+    struct hpa_graph graph;
+    double t = now_seconds();
+    if (hpa_load(&graph, cache_path, cluster, checksum, maze.size) == 0) {
+        printf("Loaded %s: %d nodes, %d edges (%.3f s)\n", cache_path, graph.num_nodes, graph.num_edges, now_seconds() - t);
+    } else {
+        hpa_build(&graph, &walls, cluster);
+        graph.source_checksum = checksum;
+        graph.source_size = maze.size;
+        printf("Built %s: %d nodes, %d edges (%.3f s)\n", cache_path, graph.num_nodes, graph.num_edges, now_seconds() - t);
+        hpa_save(&graph, cache_path);
+    }
+
+    struct maze_bitmap crumbs;
+    maze_bitmap_alloc(&crumbs, maze.rows, maze.cols);
+    struct hpa_stats stats;
+    t = now_seconds();
+    int length = hpa_solve(&graph, &walls, maze_bit_index(&walls, start_row, start_col),
+                           maze_bit_index(&walls, goal_row, goal_col), &crumbs, &stats);
+    double seconds = now_seconds() - t;
+    if (length < 0) {
+        printf("No path to the goal could be found.\n");
+    } else {
+        printf("Path length: %d moves, %lld abstract nodes popped, %lld cells visited (%.6f s)\n",
+               length, stats.nodes_popped, stats.cells_visited, seconds);
+        maze_write_marked(&maze, &crumbs, "sol.txt");
+    }
+
+    hpa_free(&graph);
+    maze_file_close(&maze);
+    maze_bitmap_free(&walls);
+    maze_bitmap_free(&crumbs);
+    return 0;
+}
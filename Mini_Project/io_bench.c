@@ -0,0 +1,212 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "maze_core.h"
+#include "maze_bits.h"
+#include "maze_io.h"
+
+// Output throughput benchmark: the old one-fprintf-per-cell writers against the buffered
+// row writers of maze_io.c, for generator-style (grid copy) and solver-style (bitmap render) output.
+// Then the input side: the old fscanf-per-character loader against maze_file_open plus
+// maze_file_to_bitmap, whose row kernels are the ones compiled in (avx2, sse2 or scalar).
+//
+// Usage: io_bench [size] [output file]
+
+double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+void report(const char *name, unsigned long long bytes, double seconds) {
+    printf("%-28s %12llu bytes %9.3f s %10.1f MB/s\n", name, bytes, seconds, bytes / seconds / 1e6);
+}
+
+long long file_size(const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        return 0;
+    }
+    fseek(file, 0, SEEK_END);
+    long long size = ftell(file);
+    fclose(file);
+    return size;
+}
+
+// The writer that writeMazeToFile/write_maze used to be
+void write_grid_per_cell(const struct maze_grid *grid, const char *path) {
+    FILE *file = fopen(path, "w");
+    fprintf(file, "%d,%d\n", grid->rows, grid->cols);
+    for (int i = 0; i < grid->rows; i++) {
+        for (int j = 0; j < grid->cols; j++) {
+            fprintf(file, "%c", maze_row(grid, i)[j]);
+        }
+        fprintf(file, "\n");
+    }
+    fclose(file);
+}
+
+// The writer that tracePath used to be
+void write_solution_per_cell(const struct maze_bitmap *walls, const struct maze_bitmap *path, const char *name) {
+    FILE *file = fopen(name, "w");
+    for (int i = 0; i < walls->rows; i++) {
+        for (int j = 0; j < walls->cols; j++) {
+            int idx = maze_bit_index(walls, i, j);
+            if (maze_bit_test(path, idx)) {
+                fprintf(file, "%c", '.');
+            } else if (maze_bit_test(walls, idx)) {
+                fprintf(file, "%c", 'x');
+            } else {
+                fprintf(file, "%c", ' ');
+            }
+        }
+        fprintf(file, "%c", '\n');
+    }
+    fclose(file);
+}
+
+void write_solution_buffered(const struct maze_bitmap *walls, const struct maze_bitmap *path, const char *name) {
+    struct maze_writer writer;
+    if (maze_writer_open(&writer, name) < 0) {
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < walls->rows; i++) {
+        char *line = maze_writer_reserve(&writer, walls->cols + 1);
+        maze_render_row(line, walls, path, i);
+        line[walls->cols] = '\n';
+    }
+    maze_writer_close(&writer);
+}
+
+// The loader that readGridFromFile used to be: an int per cell, s/g/x/space decided per character
+int **read_grid_per_char(const char *path, int *rows, int *cols, int *start_row, int *start_col) {
+    FILE *file = fopen(path, "r");
+    if (!file || fscanf(file, "%d,%d\n", rows, cols) != 2) {
+        printf("Error: Cannot read %s.\n", path);
+        exit(EXIT_FAILURE);
+    }
+    int **grid = (int **)malloc(*rows * sizeof(int *));
+    for (int i = 0; i < *rows; i++) {
+        grid[i] = (int *)malloc(*cols * sizeof(int));
+    }
+    char temp;
+    for (int i = 0; i < *rows; i++) {
+        for (int j = 0; j < *cols; j++) {
+            if (fscanf(file, "%c", &temp) != 1) {
+                break;
+            }
+            if (temp == 's') {
+                *start_row = i;
+                *start_col = j;
+                grid[i][j] = 0;
+            } else if (temp == 'g') {
+                grid[i][j] = 0;
+            } else if (temp == 'x') {
+                grid[i][j] = 1;
+            } else if (temp == ' ') {
+                grid[i][j] = 0;
+            } else if (temp == '\n') {
+                j--;
+            }
+        }
+    }
+    fclose(file);
+    return grid;
+}
+
+// Best of a few runs: the file is in the page cache after the first, so this measures parsing
+double load_mapped(const char *path, int runs, int *start_row, int *start_col) {
+    double best = 0;
+    for (int run = 0; run < runs; run++) {
+        double t = now_seconds();
+        struct maze_file file;
+        if (maze_file_open(&file, path) < 0) {
+            exit(EXIT_FAILURE);
+        }
+        struct maze_bitmap walls;
+        maze_file_to_bitmap(&file, &walls, 'x');
+        *start_row = file.start_row;
+        *start_col = file.start_col;
+        maze_file_close(&file);
+        maze_bitmap_free(&walls);
+        t = now_seconds() - t;
+        if (run == 0 || t < best) {
+            best = t;
+        }
+    }
+    return best;
+}
+
+int main(int argc, char *argv[]) {
+    int size = argc > 1 ? atoi(argv[1]) : 2001;
+    const char *out = argc > 2 ? argv[2] : "io_bench.txt";
+    if (size < 3) {
+        printf("Usage: %s [size >= 3] [output file]\n", argv[0]);
+        return 1;
+    }
+
+    // A fixed pseudo-random maze: about a third walls, and a path bitmap on every free diagonal cell
+    struct maze_grid grid;
+    maze_grid_alloc(&grid, size, size);
+    srand(12345);
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            maze_row(&grid, i)[j] = (rand() % 3 == 0) ? 'x' : ' ';
+        }
+    }
+    struct maze_bitmap walls, path;
+    maze_bitmap_from_grid(&walls, &grid, 'x');
+    maze_bitmap_alloc(&path, size, size);
+    for (int i = 0; i < size; i++) {
+        if (!maze_bit_test(&walls, maze_bit_index(&walls, i, i))) {
+            maze_bit_set(&path, maze_bit_index(&path, i, i));
+        }
+    }
+
+    printf("Output benchmark, %d x %d maze\n", size, size);
+    double t = now_seconds();
+    write_grid_per_cell(&grid, out);
+    report("generator, fprintf per cell", file_size(out), now_seconds() - t);
+
+    t = now_seconds();
+    maze_write_grid(&grid, out, 1);
+    report("generator, buffered rows", file_size(out), now_seconds() - t);
+
+    t = now_seconds();
+    write_solution_per_cell(&walls, &path, out);
+    report("solver, fprintf per cell", file_size(out), now_seconds() - t);
+
+    t = now_seconds();
+    write_solution_buffered(&walls, &path, out);
+    report("solver, buffered rows", file_size(out), now_seconds() - t);
+
+    // Input: the same maze with a start and a goal, read back
+    maze_row(&grid, 0)[0] = 's';
+    maze_row(&grid, size - 1)[size - 1] = 'g';
+    maze_write_grid(&grid, out, 1);
+    long long bytes = file_size(out);
+    int start_row = -1, start_col = -1;
+    t = now_seconds();
+    int rows, cols;
+    int **cells = read_grid_per_char(out, &rows, &cols, &start_row, &start_col);
+    report("loader, fscanf per char", bytes, now_seconds() - t);
+    for (int i = 0; i < rows; i++) {
+        free(cells[i]);
+    }
+    free(cells);
+
+    char name[64];
+    snprintf(name, sizeof(name), "loader, mapped %s rows", maze_simd_name());
+    start_row = start_col = -1;
+    report(name, bytes, load_mapped(out, 10, &start_row, &start_col));
+    if (start_row != 0 || start_col != 0) {
+        printf("Error: The start was found at (%d, %d).\n", start_row, start_col);
+        return 1;
+    }
+
+    remove(out);
+    maze_grid_free(&grid);
+    maze_bitmap_free(&walls);
+    maze_bitmap_free(&path);
+    return 0;
+}
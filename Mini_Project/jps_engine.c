@@ -0,0 +1,153 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "jps_engine.h"
+#include "search_stats.h"
+
+// Jump from cell in a vertical direction (step = +/-stride). Stops at the goal or at a cell with
+// a forced horizontal neighbour: open beside the cell but walled beside the cell it came from.
+static int jump_vertical(const struct maze_bitmap* walls, int cell, int step, int goal, long long* scanned) {
+    for (;;) {
+        int next = cell + step;
+        if (maze_bit_test(walls, next)) {
+            return -1;
+        }
+        (*scanned)++;
+        if (next == goal) {
+            return next;
+        }
+        if ((!maze_bit_test(walls, next - 1) && maze_bit_test(walls, cell - 1)) ||
+            (!maze_bit_test(walls, next + 1) && maze_bit_test(walls, cell + 1))) {
+            return next;
+        }
+        cell = next;
+    }
+}
+
+// Jump from cell in a horizontal direction (step = +/-1). Vertical moves are natural after a
+// horizontal one, so every cell passed is also probed up and down; a hit makes it a jump point.
+static int jump_horizontal(const struct maze_bitmap* walls, int cell, int step, int goal, long long* scanned) {
+    for (;;) {
+        int next = cell + step;
+        if (maze_bit_test(walls, next)) {
+            return -1;
+        }
+        (*scanned)++;
+        if (next == goal || jump_vertical(walls, next, -walls->stride, goal, scanned) >= 0 ||
+            jump_vertical(walls, next, walls->stride, goal, scanned) >= 0) {
+            return next;
+        }
+        cell = next;
+    }
+}
+
+int jps_search(const struct maze_bitmap* walls, int start, int goal, struct maze_bitmap* path,
+               enum OpenListKind kind, struct jps_stats* stats) {
+    int stride = walls->stride;
+    int numCells = walls->rows * stride;
+    int goal_row = goal / stride, goal_col = goal % stride;
+    struct jps_stats local = { 0, 0, 0 };
+    STATS_DECLARE(counters, "jps");
+
+    // Per-cell state, indexed like the bitmap: cost so far, parent jump point, arrival step
+    int* g = (int*)malloc(numCells * sizeof(int));
+    int* parent = (int*)malloc(numCells * sizeof(int));
+    int* arrival = (int*)malloc(numCells * sizeof(int));
+    struct maze_bitmap closed;
+    maze_bitmap_alloc(&closed, walls->rows, walls->cols);
+    if (!g || !parent || !arrival) {
+        printf("Error: Cannot allocate JPS state.\n");
+        exit(EXIT_FAILURE);
+    }
+    struct OpenList* open = createOpenList(numCells, kind);
+
+    g[start] = 0;
+    parent[start] = start;
+    arrival[start] = 0;
+    openListPush(open, start, 0);
+    local.pushes++;
+    STATS_INC(counters, generated);
+    STATS_ADD(counters, state_bytes, 3LL * numCells * sizeof(int) + maze_bitmap_bytes(&closed));
+    STATS_PHASE(counters, "search");
+
+    int length = -1;
+    int cell;
+    while ((cell = openListPop(open)) != -1) {
+        local.pops++;
+        if (cell == goal) {
+            length = g[goal];
+            break;
+        }
+        maze_bit_set(&closed, cell);
+        STATS_INC(counters, expanded);
+
+        // Successor directions allowed after arriving with this step (all four at the start)
+        int steps[4], count = 0;
+        int step = arrival[cell];
+        if (step == 0) {
+            steps[count++] = -1;
+            steps[count++] = 1;
+            steps[count++] = -stride;
+            steps[count++] = stride;
+        } else if (step == 1 || step == -1) {
+            steps[count++] = step;
+            steps[count++] = -stride;
+            steps[count++] = stride;
+        } else {
+            steps[count++] = step;
+            if (!maze_bit_test(walls, cell - 1) && maze_bit_test(walls, cell - step - 1)) {
+                steps[count++] = -1;
+            }
+            if (!maze_bit_test(walls, cell + 1) && maze_bit_test(walls, cell - step + 1)) {
+                steps[count++] = 1;
+            }
+        }
+
+        for (int i = 0; i < count; i++) {
+            int vertical = steps[i] != 1 && steps[i] != -1;
+            int next = vertical ? jump_vertical(walls, cell, steps[i], goal, &local.scanned)
+                                : jump_horizontal(walls, cell, steps[i], goal, &local.scanned);
+            if (next < 0 || maze_bit_test(&closed, next)) {
+                continue;
+            }
+            int distance = abs(next - cell) / (vertical ? stride : 1);
+            int gNew = g[cell] + distance;
+            if (!openListContains(open, next) || gNew < g[next]) {
+                STATS_INC(counters, generated);
+                if (openListContains(open, next)) {
+                    STATS_INC(counters, reopened);
+                }
+                g[next] = gNew;
+                parent[next] = cell;
+                arrival[next] = steps[i];
+                int h = abs(next / stride - goal_row) + abs(next % stride - goal_col);
+                openListPush(open, next, gNew + h);
+                local.pushes++;
+                STATS_MAX(counters, peak_open, open->size);
+            }
+        }
+    }
+    STATS_PHASE(counters, "trace");
+
+    // Expand the jump point chain back into individual cells
+    if (length >= 0) {
+        for (int at = goal; at != start; at = parent[at]) {
+            int step = arrival[at];
+            for (int c = at - step; c != parent[at]; c -= step) {
+                maze_bit_set(path, c);
+            }
+            maze_bit_set(path, parent[at]);
+        }
+    }
+
+    STATS_ADD(counters, state_bytes, openListBytes(open));
+    STATS_REPORT(counters);
+    if (stats) {
+        *stats = local;
+    }
+    freeOpenList(open);
+    maze_bitmap_free(&closed);
+    free(g);
+    free(parent);
+    free(arrival);
+    return length;
+}
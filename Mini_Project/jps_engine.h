@@ -0,0 +1,23 @@
+#ifndef JPS_ENGINE_H
+#define JPS_ENGINE_H
+
+#include "maze_bits.h"
+#include "open_list.h"
+
+// Work done by one search, for comparison with plain A*
+struct jps_stats {
+    long long pushes;     // Open-list push/decrease-key calls
+    long long pops;       // Jump points taken off the open list
+    long long scanned;    // Cells stepped over while jumping
+};
+
+// Jump Point Search for 4-connected, unit-cost grids over a sealed wall bitmap. Straight runs
+// are scanned without touching the open list; only jump points (the goal, cells with a forced
+// turn, and horizontal cells from which a vertical jump finds one) are pushed. Canonical paths go
+// horizontally first and turn from vertical to horizontal only when forced.
+// When the goal is reached every cell on the path (start included, goal excluded) is set in path,
+// like dfs_iterative. Returns the path length in moves, or -1 if the goal is unreachable.
+int jps_search(const struct maze_bitmap* walls, int start, int goal, struct maze_bitmap* path,
+               enum OpenListKind kind, struct jps_stats* stats);
+
+#endif
@@ -0,0 +1,428 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "junction_graph.h"
+#include "search_stats.h"
+#include "maze_io.h"
+#include "open_list.h"
+
+// Linear offset of each direction: up, down, left, right (d ^ 1 is the opposite direction)
+static void direction_offsets(int stride, int offsets[4]) {
+    offsets[0] = -stride;
+    offsets[1] = stride;
+    offsets[2] = -1;
+    offsets[3] = 1;
+}
+
+// Node id of a node cell (node_cell is sorted), or -1
+static int node_id(const struct junction_graph* graph, int cell) {
+    int lo = 0, hi = graph->num_nodes - 1;
+    while (lo <= hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (graph->node_cell[mid] < cell) {
+            lo = mid + 1;
+        } else if (graph->node_cell[mid] > cell) {
+            hi = mid - 1;
+        } else {
+            return mid;
+        }
+    }
+    return -1;
+}
+
+// Follow a corridor from cell `from`, leaving in direction dir, until a node or the stop cell
+// (-1 for none) is reached. Cells walked over (from included, the end excluded) are set in mark
+// when it is not NULL. Returns the end cell, with the move count in *length and the direction
+// of the last move in *last_dir, or -1 if the corridor is a loop back to from without a node.
+static int walk_corridor(const struct junction_graph* graph, const struct maze_bitmap* walls, int from, int dir,
+                         int stop, int* length, int* last_dir, struct maze_bitmap* mark) {
+    int offsets[4];
+    direction_offsets(walls->stride, offsets);
+    int cell = from + offsets[dir], moves = 1;
+    if (mark) {
+        maze_bit_set(mark, from);
+    }
+    while (cell != stop && !maze_bit_test(&graph->is_node, cell)) {
+        if (cell == from) {
+            return -1;
+        }
+        if (mark) {
+            maze_bit_set(mark, cell);
+        }
+        // A corridor cell has exactly two open neighbours: keep going through the one not just left
+        int next_dir = -1;
+        for (int d = 0; d < 4; d++) {
+            if (d != (dir ^ 1) && !maze_bit_test(walls, cell + offsets[d])) {
+                next_dir = d;
+                break;
+            }
+        }
+        if (next_dir < 0) {
+            return -1;
+        }
+        dir = next_dir;
+        cell += offsets[dir];
+        moves++;
+    }
+    *length = moves;
+    *last_dir = dir;
+    return cell;
+}
+
+static int open_degree(const struct maze_bitmap* walls, int cell, const int offsets[4]) {
+    int degree = 0;
+    for (int d = 0; d < 4; d++) {
+        degree += !maze_bit_test(walls, cell + offsets[d]);
+    }
+    return degree;
+}
+
+static void alloc_arrays(struct junction_graph* graph) {
+    graph->node_cell = (int*)malloc((graph->num_nodes + 1) * sizeof(int));
+    graph->first_edge = (int*)malloc((graph->num_nodes + 1) * sizeof(int));
+    graph->edge_target = (int*)malloc((graph->num_edges + 1) * sizeof(int));
+    graph->edge_length = (int*)malloc((graph->num_edges + 1) * sizeof(int));
+    graph->edge_dir = (unsigned char*)malloc(graph->num_edges + 1);
+    if (!graph->node_cell || !graph->first_edge || !graph->edge_target || !graph->edge_length || !graph->edge_dir) {
+        printf("Error: Cannot allocate the junction graph.\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+void junction_graph_build(struct junction_graph* graph, const struct maze_bitmap* walls, int start, int goal) {
+    memset(graph, 0, sizeof(*graph));
+    graph->rows = walls->rows;
+    graph->cols = walls->cols;
+    graph->stride = walls->stride;
+    int offsets[4];
+    direction_offsets(walls->stride, offsets);
+
+    // Nodes: every open cell that is not a plain corridor cell, plus start and goal
+    maze_bitmap_alloc(&graph->is_node, walls->rows, walls->cols);
+    long long edge_bound = 0;
+    for (int row = 0; row < walls->rows; row++) {
+        for (int col = 0; col < walls->cols; col++) {
+            int cell = maze_bit_index(walls, row, col);
+            if (maze_bit_test(walls, cell)) {
+                continue;
+            }
+            int degree = open_degree(walls, cell, offsets);
+            if (degree != 2 || cell == start || cell == goal) {
+                maze_bit_set(&graph->is_node, cell);
+                graph->num_nodes++;
+                edge_bound += degree;
+            }
+        }
+    }
+    graph->num_edges = (int)edge_bound;
+    alloc_arrays(graph);
+
+    int n = 0;
+    for (int row = 0; row < walls->rows; row++) {
+        for (int col = 0; col < walls->cols; col++) {
+            int cell = maze_bit_index(walls, row, col);
+            if (maze_bit_test(&graph->is_node, cell)) {
+                graph->node_cell[n++] = cell;
+            }
+        }
+    }
+
+    // Edges: walk every corridor leaving every node; loops back to the same node are dropped
+    int e = 0;
+    for (n = 0; n < graph->num_nodes; n++) {
+        graph->first_edge[n] = e;
+        for (int d = 0; d < 4; d++) {
+            int cell = graph->node_cell[n];
+            if (maze_bit_test(walls, cell + offsets[d])) {
+                continue;
+            }
+            int length, last_dir;
+            int end = walk_corridor(graph, walls, cell, d, -1, &length, &last_dir, NULL);
+            if (end < 0 || end == cell) {
+                continue;
+            }
+            graph->edge_target[e] = node_id(graph, end);
+            graph->edge_length[e] = length;
+            graph->edge_dir[e] = (unsigned char)d;
+            e++;
+        }
+    }
+    graph->first_edge[graph->num_nodes] = e;
+    graph->num_edges = e;
+}
+
+void junction_graph_free(struct junction_graph* graph) {
+    free(graph->node_cell);
+    free(graph->first_edge);
+    free(graph->edge_target);
+    free(graph->edge_length);
+    free(graph->edge_dir);
+    maze_bitmap_free(&graph->is_node);
+    memset(graph, 0, sizeof(*graph));
+}
+
+void junction_graph_path(const char* maze_path, char* out, size_t size) {
+    maze_sidecar_path(maze_path, ".jgr", out, size);
+}
+
+// On-disk header; the arrays follow in the order of struct junction_graph
+struct jgr_header {
+    char magic[4];
+    uint32_t version;
+    int32_t rows, cols, stride;
+    int32_t num_nodes, num_edges;
+    uint32_t reserved;
+    uint64_t source_checksum;
+    uint64_t source_size;
+};
+
+int junction_graph_save(const struct junction_graph* graph, const char* path) {
+    struct jgr_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, JGR_MAGIC, 4);
+    header.version = JGR_VERSION;
+    header.rows = graph->rows;
+    header.cols = graph->cols;
+    header.stride = graph->stride;
+    header.num_nodes = graph->num_nodes;
+    header.num_edges = graph->num_edges;
+    header.source_checksum = graph->source_checksum;
+    header.source_size = graph->source_size;
+
+    struct maze_writer writer;
+    if (maze_writer_open(&writer, path) < 0) {
+        return -1;
+    }
+    maze_writer_write(&writer, (const char*)&header, sizeof(header));
+    maze_writer_write(&writer, (const char*)graph->node_cell, graph->num_nodes * sizeof(int32_t));
+    maze_writer_write(&writer, (const char*)graph->first_edge, (graph->num_nodes + 1) * sizeof(int32_t));
+    maze_writer_write(&writer, (const char*)graph->edge_target, graph->num_edges * sizeof(int32_t));
+    maze_writer_write(&writer, (const char*)graph->edge_length, graph->num_edges * sizeof(int32_t));
+    maze_writer_write(&writer, (const char*)graph->edge_dir, graph->num_edges);
+    return maze_writer_close(&writer);
+}
+
+// Check the arrays of a loaded graph, so a corrupt file cannot send the search out of bounds
+static int graph_is_consistent(const struct junction_graph* graph) {
+    int cells = graph->rows * graph->stride;
+    for (int n = 0; n < graph->num_nodes; n++) {
+        int cell = graph->node_cell[n];
+        if (cell < 0 || cell >= cells || cell % graph->stride >= graph->cols ||
+            (n > 0 && cell <= graph->node_cell[n - 1]) ||
+            graph->first_edge[n] > graph->first_edge[n + 1]) {
+            return 0;
+        }
+    }
+    if (graph->first_edge[0] != 0 || graph->first_edge[graph->num_nodes] != graph->num_edges) {
+        return 0;
+    }
+    for (int e = 0; e < graph->num_edges; e++) {
+        if (graph->edge_target[e] < 0 || graph->edge_target[e] >= graph->num_nodes ||
+            graph->edge_length[e] < 1 || graph->edge_dir[e] > 3) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int junction_graph_load(struct junction_graph* graph, const char* path, uint64_t source_checksum, uint64_t source_size) {
+    memset(graph, 0, sizeof(*graph));
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return -1;
+    }
+
+    struct jgr_header header;
+    if (fread(&header, sizeof(header), 1, file) != 1 || memcmp(header.magic, JGR_MAGIC, 4) != 0 ||
+        header.version != JGR_VERSION) {
+        printf("Error: %s is not a junction graph file.\n", path);
+        fclose(file);
+        return -1;
+    }
+    if (header.source_checksum != source_checksum || header.source_size != source_size) {
+        printf("Note: %s was built from a different maze; rebuilding.\n", path);
+        fclose(file);
+        return -1;
+    }
+    if (header.rows < 1 || header.cols < 1 || header.stride != maze_stride_for(header.cols) ||
+        (long long)header.rows * header.stride > INT_MAX || header.num_nodes < 0 || header.num_edges < 0 ||
+        (long long)header.num_edges > 4LL * header.num_nodes) {
+        printf("Error: %s has an invalid header.\n", path);
+        fclose(file);
+        return -1;
+    }
+
+    graph->rows = header.rows;
+    graph->cols = header.cols;
+    graph->stride = header.stride;
+    graph->num_nodes = header.num_nodes;
+    graph->num_edges = header.num_edges;
+    graph->source_checksum = header.source_checksum;
+    graph->source_size = header.source_size;
+    alloc_arrays(graph);
+    size_t nodes = graph->num_nodes, edges = graph->num_edges;
+    int ok = fread(graph->node_cell, sizeof(int32_t), nodes, file) == nodes &&
+             fread(graph->first_edge, sizeof(int32_t), nodes + 1, file) == nodes + 1 &&
+             fread(graph->edge_target, sizeof(int32_t), edges, file) == edges &&
+             fread(graph->edge_length, sizeof(int32_t), edges, file) == edges &&
+             fread(graph->edge_dir, 1, edges, file) == edges;
+    fclose(file);
+    if (!ok || !graph_is_consistent(graph)) {
+        printf("Error: %s is truncated or corrupt.\n", path);
+        junction_graph_free(graph);
+        return -1;
+    }
+
+    maze_bitmap_alloc(&graph->is_node, graph->rows, graph->cols);
+    for (int n = 0; n < graph->num_nodes; n++) {
+        maze_bit_set(&graph->is_node, graph->node_cell[n]);
+    }
+    return 0;
+}
+
+// Relax node (or the goal slot) to cost g, reached by walking from via_cell in via_dir
+static void relax(struct OpenList* open, int* g, int* parent, int* via_cell, unsigned char* via_dir,
+                  int node, int cost, int h, int from_node, int cell, int dir) {
+    if (cost < g[node]) {
+        g[node] = cost;
+        parent[node] = from_node;
+        via_cell[node] = cell;
+        via_dir[node] = (unsigned char)dir;
+        openListPush(open, node, cost + h);
+    }
+}
+
+int junction_graph_solve(const struct junction_graph* graph, const struct maze_bitmap* walls, int start, int goal,
+                         struct maze_bitmap* path, struct junction_stats* stats) {
+    struct junction_stats local = { 0, 0 };
+    if (stats) {
+        *stats = local;
+    }
+    if (maze_bit_test(walls, start) || maze_bit_test(walls, goal)) {
+        return -1;
+    }
+    if (start == goal) {
+        return 0;
+    }
+    STATS_DECLARE(counters, "junction");
+
+    int offsets[4];
+    direction_offsets(walls->stride, offsets);
+    int goal_row = goal / graph->stride, goal_col = goal % graph->stride;
+
+    // Graph nodes, plus one extra slot for the goal when it sits inside a corridor
+    int slots = graph->num_nodes + 1;
+    int start_node = node_id(graph, start);
+    int goal_node = node_id(graph, goal);
+    if (goal_node < 0) {
+        goal_node = graph->num_nodes;
+    }
+    int* g = (int*)malloc(slots * sizeof(int));
+    int* parent = (int*)malloc(slots * sizeof(int));
+    int* via_cell = (int*)malloc(slots * sizeof(int));
+    unsigned char* via_dir = (unsigned char*)malloc(slots);
+    if (!g || !parent || !via_cell || !via_dir) {
+        printf("Error: Cannot allocate junction search state.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int n = 0; n < slots; n++) {
+        g[n] = INT_MAX;
+    }
+    struct OpenList* open = createOpenList(slots, OPEN_LIST_HEAP);
+
+    // Corridors around a goal that is not a node: which node ends them, how far, and how to leave it
+    int goal_end[4], goal_len[4], goal_dir[4], goal_ends = 0;
+    if (goal_node == graph->num_nodes) {
+        for (int d = 0; d < 4; d++) {
+            int length, last_dir;
+            if (maze_bit_test(walls, goal + offsets[d])) {
+                continue;
+            }
+            int end = walk_corridor(graph, walls, goal, d, start, &length, &last_dir, NULL);
+            local.cells_walked += end < 0 ? 0 : length;
+            if (end >= 0 && (end != start || start_node >= 0)) {
+                goal_end[goal_ends] = node_id(graph, end);
+                goal_len[goal_ends] = length;
+                goal_dir[goal_ends] = last_dir ^ 1;
+                goal_ends++;
+            }
+        }
+    }
+
+    // Start: a node, or the corridor cells on either side of it (which may reach the goal directly)
+    if (start_node >= 0) {
+        relax(open, g, parent, via_cell, via_dir, start_node, 0, 0, -1, start, 0);
+    } else {
+        for (int d = 0; d < 4; d++) {
+            int length, last_dir;
+            if (maze_bit_test(walls, start + offsets[d])) {
+                continue;
+            }
+            int end = walk_corridor(graph, walls, start, d, goal, &length, &last_dir, NULL);
+            if (end < 0) {
+                continue;
+            }
+            local.cells_walked += length;
+            int node = end == goal ? goal_node : node_id(graph, end);
+            int h = abs(end / graph->stride - goal_row) + abs(end % graph->stride - goal_col);
+            relax(open, g, parent, via_cell, via_dir, node, length, h, -1, start, d);
+        }
+    }
+
+    STATS_PHASE(counters, "search");
+    int length = -1;
+    int node;
+    while ((node = openListPop(open)) != -1) {
+        local.nodes_popped++;
+        STATS_MAX(counters, peak_open, open->size + 1);
+        if (node == goal_node) {
+            length = g[node];
+            break;
+        }
+        int cell = graph->node_cell[node];
+        for (int k = 0; k < goal_ends; k++) {
+            if (goal_end[k] == node) {
+                relax(open, g, parent, via_cell, via_dir, goal_node, g[node] + goal_len[k], 0, node, cell, goal_dir[k]);
+            }
+        }
+        for (int e = graph->first_edge[node]; e < graph->first_edge[node + 1]; e++) {
+            int target = graph->edge_target[e];
+            int target_cell = graph->node_cell[target];
+            int h = abs(target_cell / graph->stride - goal_row) + abs(target_cell % graph->stride - goal_col);
+            relax(open, g, parent, via_cell, via_dir, target, g[node] + graph->edge_length[e], h, node, cell, graph->edge_dir[e]);
+        }
+    }
+
+    // Walk every corridor of the chain again, marking its cells
+    STATS_PHASE(counters, "trace");
+    if (length >= 0) {
+        for (int n = goal_node; n != -1 && n != start_node; n = parent[n]) {
+            int end_cell = n == graph->num_nodes ? goal : graph->node_cell[n];
+            int moves, last_dir;
+            walk_corridor(graph, walls, via_cell[n], via_dir[n], end_cell, &moves, &last_dir, path);
+        }
+    }
+
+#ifdef MAZE_STATS
+    // Every push after a slot's first is a re-opening with a lower cost
+    long long touched = 0;
+    for (int n = 0; n < slots; n++) {
+        touched += g[n] != INT_MAX;
+    }
+    STATS_ADD(counters, expanded, local.nodes_popped);
+    STATS_ADD(counters, generated, open->pushes);
+    STATS_ADD(counters, reopened, open->pushes - touched);
+    STATS_ADD(counters, state_bytes, openListBytes(open) + (long long)slots * (3 * sizeof(int) + 1));
+    STATS_REPORT(counters);
+#endif
+    if (stats) {
+        *stats = local;
+    }
+    freeOpenList(open);
+    free(g);
+    free(parent);
+    free(via_cell);
+    free(via_dir);
+    return length;
+}
@@ -0,0 +1,53 @@
+#ifndef JUNCTION_GRAPH_H
+#define JUNCTION_GRAPH_H
+
+#include <stdint.h>
+#include "maze_bits.h"
+
+#define JGR_MAGIC "JGR1"
+#define JGR_VERSION 1
+
+// Corridors collapsed into a weighted graph. Nodes are the open cells whose degree is not 2
+// (junctions and dead ends) plus the maze's start and goal; each edge is one corridor between
+// two nodes. An edge stores its length and the direction it leaves its source node, which is
+// enough to walk the corridor's cell run again when a path is expanded.
+// Cells are linear bitmap indices (row * stride + col).
+struct junction_graph {
+    int rows, cols, stride;
+    int num_nodes, num_edges;
+    int* node_cell;            // Cell of each node, in increasing (row-major) order
+    int* first_edge;           // Edges of node n are first_edge[n] .. first_edge[n + 1] - 1
+    int* edge_target;          // Node at the other end of the corridor
+    int* edge_length;          // Moves along the corridor
+    unsigned char* edge_dir;   // Direction leaving the source node: 0 up, 1 down, 2 left, 3 right
+    struct maze_bitmap is_node; // One bit per cell: set for node cells
+    uint64_t source_checksum;  // Checksum of the maze file the graph was built from
+    uint64_t source_size;
+};
+
+// Statistics of one query
+struct junction_stats {
+    long long nodes_popped;    // Graph nodes taken off the open list
+    long long cells_walked;    // Corridor cells stepped over while attaching start/goal
+};
+
+// Build the graph from a sealed wall bitmap; start and goal (-1 for none) become nodes
+void junction_graph_build(struct junction_graph* graph, const struct maze_bitmap* walls, int start, int goal);
+void junction_graph_free(struct junction_graph* graph);
+
+// Save/load the graph next to the maze. Load fails (returns -1) if the file is missing,
+// malformed, or was built from a different maze file. Both print a message on error.
+int junction_graph_save(const struct junction_graph* graph, const char* path);
+int junction_graph_load(struct junction_graph* graph, const char* path, uint64_t source_checksum, uint64_t source_size);
+
+// Derive the graph file name from the maze file name: maze.txt -> maze.txt.jgr
+void junction_graph_path(const char* maze_path, char* out, size_t size);
+
+// Shortest path from start to goal (any open cells, not necessarily nodes) searched over the
+// graph with A*. Only corridors holding start or goal are walked during the search; the path is
+// expanded back into cells at the end and set in path (start included, goal excluded).
+// Returns the path length in moves, or -1 if the goal is unreachable.
+int junction_graph_solve(const struct junction_graph* graph, const struct maze_bitmap* walls, int start, int goal,
+                         struct maze_bitmap* path, struct junction_stats* stats);
+
+#endif
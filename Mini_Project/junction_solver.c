@@ -0,0 +1,87 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "maze_core.h"
+#include "maze_bits.h"
+#include "maze_io.h"
+#include "junction_graph.h"
+
+// Solve a maze over its junction graph. The graph is built once and saved next to the maze
+// (maze.txt -> maze.jgr); later runs load it, so a query only touches junctions and the
+// corridors holding its start and goal. The solution is written to sol.txt like solver.c.
+//
+// Usage: junction_solver [maze file] [start_row start_col goal_row goal_col]
+
+double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char *argv[]) {
+    const char *maze_path = argc > 1 ? argv[1] : "maze.txt";
+    if (argc != 1 && argc != 2 && argc != 6) {
+        printf("Usage: %s [maze file] [start_row start_col goal_row goal_col]\n", argv[0]);
+        return 1;
+    }
+
+    struct maze_file maze;
+    if (maze_file_open(&maze, maze_path) < 0) {
+        return 1;
+    }
+    struct maze_bitmap walls;
+    maze_file_to_bitmap(&maze, &walls, 'x');
+
+    int start_row = maze.start_row, start_col = maze.start_col;
+    int goal_row = maze.goal_row, goal_col = maze.goal_col;
+    if (argc == 6) {
+        start_row = atoi(argv[2]);
+        start_col = atoi(argv[3]);
+        goal_row = atoi(argv[4]);
+        goal_col = atoi(argv[5]);
+    }
+    if (start_row < 0 || start_row >= maze.rows || start_col < 0 || start_col >= maze.cols ||
+        goal_row < 0 || goal_row >= maze.rows || goal_col < 0 || goal_col >= maze.cols) {
+        printf("Error: Start and goal must be inside the %d x %d maze.\n", maze.rows, maze.cols);
+        return 1;
+    }
+
+    // Reuse the saved graph when it was built from this exact maze file
+    char graph_path[4096];
+    junction_graph_path(maze_path, graph_path, sizeof(graph_path));
+    uint64_t checksum = mzb_checksum(maze.data, maze.size);
+    struct junction_graph graph;
+    double t = now_seconds();
+    if (junction_graph_load(&graph, graph_path, checksum, maze.size) == 0) {
+        printf("Loaded %s: %d nodes, %d edges (%.3f s)\n", graph_path, graph.num_nodes, graph.num_edges, now_seconds() - t);
+    } else {
+        int file_start = maze.start_row >= 0 ? maze_bit_index(&walls, maze.start_row, maze.start_col) : -1;
+        int file_goal = maze.goal_row >= 0 ? maze_bit_index(&walls, maze.goal_row, maze.goal_col) : -1;
+        junction_graph_build(&graph, &walls, file_start, file_goal);
+        graph.source_checksum = checksum;
+        graph.source_size = maze.size;
+        printf("Built %s: %d nodes, %d edges (%.3f s)\n", graph_path, graph.num_nodes, graph.num_edges, now_seconds() - t);
+        junction_graph_save(&graph, graph_path);
+    }
+
+    struct maze_bitmap crumbs;
+    maze_bitmap_alloc(&crumbs, maze.rows, maze.cols);
+    struct junction_stats stats;
+    t = now_seconds();
+    int length = junction_graph_solve(&graph, &walls, maze_bit_index(&walls, start_row, start_col),
+                                      maze_bit_index(&walls, goal_row, goal_col), &crumbs, &stats);
+    double seconds = now_seconds() - t;
+    if (length < 0) {
+        printf("No path to the goal could be found.\n");
+    } else {
+        printf("Path length: %d moves, %lld nodes popped, %lld corridor cells walked (%.6f s)\n",
+               length, stats.nodes_popped, stats.cells_walked, seconds);
+        maze_write_marked(&maze, &crumbs, "sol.txt");
+    }
+
+    junction_graph_free(&graph);
+    maze_file_close(&maze);
+    maze_bitmap_free(&walls);
+    maze_bitmap_free(&crumbs);
+    return 0;
+}
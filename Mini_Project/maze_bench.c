@@ -0,0 +1,582 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include "maze_core.h"
+#include "maze_bits.h"
+#include "maze_io.h"
+#include "dfs_engine.h"
+#include "Astar_code.h"
+#include "ao_engine.h"
+
+// The gitcode.c solver is a standalone program; its solve() is used as is, without its main
+#define GITCODE_NO_MAIN
+#include "gitcode.c"
+
+// Reproducible benchmark of the DFS, A*, AO* and gitcode solvers. Mazes of every size and type
+// are generated from a fixed seed and saved as text: simple is a perfect maze, obstacles an open
+// room with 10% of the cells walled at random, so it has many routes (maze_generator's option 2
+// adds those walls to a perfect maze instead, which almost always cuts the goal off). Each
+// solver runs in its own process, so its peak RSS is its own: warm-up runs, then timed
+// repetitions of three phases on the monotonic clock, load (read and parse the file), solve and
+// write (the solution file). Reported per case: median and p95 of every phase, nodes expanded,
+// path length and peak RSS. A case that runs past the timeout is killed and reported as such:
+// gitcode's solver forgets cells when it backtracks, so on open grids it can take exponential time.
+// A* runs with each heuristic: astar (Manhattan), dijkstra (zero) and alt (landmarks, whose
+// tables are built on the first warm-up run and then loaded from the cache file).
+// A scaling check follows the table: every solver runs on perfect mazes of growing size, and a
+// solve time per cell that grows by more than BENCH_SCALING_LIMIT from one size to the next is
+// flagged. Work per node that grows with the maze shows up there even while every case is fast.
+//
+// Usage: maze_bench [--sizes 101,501,1001] [--types simple,obstacles] [--solvers dfs,astar,dijkstra,alt,ao,gitcode]
+//                   [--reps 10] [--warmup 2] [--seed 1] [--timeout 60] [--csv file] [--json file]
+//                   [--scaling 501,1001,2001 | none]
+
+#define BENCH_MAX_REPS 1000
+#define BENCH_MAX_ITEMS 16
+#define BENCH_SCALING_LIMIT 2.0   // Allowed growth of the solve time per cell between two sizes
+#define BENCH_SCALING_MIN_MS 1.0  // Solves faster than this are too noisy to compare
+
+enum bench_status { CASE_OK, CASE_TIMEOUT, CASE_FAILED };
+const char *status_names[] = { "ok", "timeout", "failed" };
+
+enum bench_phase { PHASE_LOAD, PHASE_SOLVE, PHASE_WRITE, PHASE_COUNT };
+const char *phase_names[PHASE_COUNT] = { "load", "solve", "write" };
+
+// What a solver process sends back to the driver
+struct bench_result {
+    int reps;
+    double seconds[PHASE_COUNT][BENCH_MAX_REPS];
+    long long nodes;     // Cells expanded by one solve
+    int path_length;     // Cells on the path, -1 if the goal was not reached
+    long peak_rss_kb;
+};
+
+// One loaded maze, in whichever representation the solver works on
+struct bench_maze {
+    struct maze_file file;
+    struct maze_bitmap walls;
+    struct maze_bitmap visited;
+    struct maze_bitmap path;
+    char **lines;        // gitcode: one malloc'd row per line, the goal marked 'O'
+    struct Landmarks landmarks; // alt: distance tables of the landmarks
+    int start, goal;
+};
+
+// Function to check whether a solver is A* with one of the heuristics
+bool is_astar(const char *solver, enum HeuristicKind *kind) {
+    if (strcmp(solver, "astar") == 0) {
+        *kind = HEURISTIC_MANHATTAN;
+    } else if (strcmp(solver, "dijkstra") == 0) {
+        *kind = HEURISTIC_ZERO;
+    } else if (strcmp(solver, "alt") == 0) {
+        *kind = HEURISTIC_ALT;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Random number in [0, bound) from a splitmix64 stream
+int bench_random(unsigned long long *stream, int bound) {
+    unsigned long long z = (*stream += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return (int)((z ^ (z >> 31)) % (unsigned long long)bound);
+}
+
+// Function to generate a seeded size x size maze: a perfect maze carved by an iterative
+// backtracker like maze_generator's, or an open room with 10% random walls, inside a wall
+// border with start at (1, 1) and goal at (size - 2, size - 2)
+void generate_maze(const char *path, int size, int obstacles, unsigned long long seed) {
+    struct maze_grid grid;
+    maze_grid_alloc(&grid, size, size);
+    maze_grid_fill(&grid, 'x');
+    unsigned long long stream = seed;
+
+    if (obstacles) {
+        for (int i = 1; i < size - 1; i++) {
+            for (int j = 1; j < size - 1; j++) {
+                grid.cells[maze_index(&grid, i, j)] = bench_random(&stream, 10) == 0 ? 'x' : ' ';
+            }
+        }
+    } else {
+        int *stack = (int *)malloc((size_t)size * size * sizeof(int));
+        if (!stack) {
+            printf("Error: Cannot allocate the generator stack.\n");
+            exit(EXIT_FAILURE);
+        }
+        const int steps[4][2] = { {-2, 0}, {2, 0}, {0, -2}, {0, 2} };
+        int top = 0;
+        stack[top++] = maze_index(&grid, 1, 1);
+        grid.cells[stack[0]] = ' ';
+        while (top > 0) {
+            int cell = stack[top - 1];
+            int row = maze_row_of(&grid, cell), col = maze_col_of(&grid, cell);
+            int options[4], count = 0;
+            for (int d = 0; d < 4; d++) {
+                int r = row + steps[d][0], c = col + steps[d][1];
+                if (r > 0 && r < size - 1 && c > 0 && c < size - 1 && grid.cells[maze_index(&grid, r, c)] == 'x') {
+                    options[count++] = d;
+                }
+            }
+            if (count == 0) {
+                top--;
+                continue;
+            }
+            int d = options[bench_random(&stream, count)];
+            grid.cells[maze_index(&grid, row + steps[d][0] / 2, col + steps[d][1] / 2)] = ' ';
+            int next = maze_index(&grid, row + steps[d][0], col + steps[d][1]);
+            grid.cells[next] = ' ';
+            stack[top++] = next;
+        }
+        free(stack);
+    }
+    grid.cells[maze_index(&grid, 1, 1)] = 's';
+    grid.cells[maze_index(&grid, size - 2, size - 2)] = 'g';
+    if (maze_write_grid(&grid, path, 1) < 0) {
+        exit(EXIT_FAILURE);
+    }
+    maze_grid_free(&grid);
+}
+
+// Load phase: map the file and build the solver's representation
+void load_maze(struct bench_maze *m, const char *path, const char *solver) {
+    memset(m, 0, sizeof(*m));
+    if (maze_file_open(&m->file, path) < 0) {
+        exit(EXIT_FAILURE);
+    }
+    if (strcmp(solver, "gitcode") == 0) {
+        m->lines = (char **)malloc(m->file.rows * sizeof(char *));
+        for (int i = 0; i < m->file.rows; i++) {
+            m->lines[i] = (char *)malloc(m->file.cols);
+            memcpy(m->lines[i], maze_file_row(&m->file, i), m->file.cols);
+        }
+        m->lines[m->file.goal_row][m->file.goal_col] = 'O';
+        return;
+    }
+    maze_file_to_bitmap(&m->file, &m->walls, 'x');
+    maze_bitmap_alloc(&m->visited, m->file.rows, m->file.cols);
+    maze_bitmap_alloc(&m->path, m->file.rows, m->file.cols);
+    m->start = maze_bit_index(&m->walls, m->file.start_row, m->file.start_col);
+    m->goal = maze_bit_index(&m->walls, m->file.goal_row, m->file.goal_col);
+    enum HeuristicKind kind;
+    if (is_astar(solver, &kind) && heuristicNeedsLandmarks(kind) &&
+        prepareLandmarks(&m->landmarks, path, &m->walls, ALT_DEFAULT_LANDMARKS) < 0) {
+        exit(EXIT_FAILURE);
+    }
+}
+
+void unload_maze(struct bench_maze *m) {
+    if (m->lines) {
+        for (int i = 0; i < m->file.rows; i++) {
+            free(m->lines[i]);
+        }
+        free(m->lines);
+    } else {
+        maze_bitmap_free(&m->walls);
+        maze_bitmap_free(&m->visited);
+        maze_bitmap_free(&m->path);
+        freeLandmarks(&m->landmarks);
+    }
+    maze_file_close(&m->file);
+}
+
+long long count_bits(const struct maze_bitmap *bits) {
+    long long count = 0;
+    for (int i = 0; i < bits->rows; i++) {
+        for (int j = 0; j < bits->cols; j++) {
+            count += maze_bit_test(bits, maze_bit_index(bits, i, j));
+        }
+    }
+    return count;
+}
+
+// Solve phase. Returns the path length in cells (-1 if none) and sets the nodes expanded.
+int solve_maze(struct bench_maze *m, const char *solver, long long *nodes) {
+    // Direction order of solve_maze's DFS
+    static const int dfs_directions[4][2] = { {0, -1}, {1, 0}, {0, 1}, {-1, 0} };
+
+    if (strcmp(solver, "gitcode") == 0) {
+        solve_expansions = 0;
+        Coordinate start = new_coordinate(m->file.start_row, m->file.start_col);
+        Coordinate end = solve(start, m->lines, m->file.rows, m->file.cols);
+        *nodes = solve_expansions;
+        if (equals_coordinates(start, end)) {
+            return -1;
+        }
+        long long length = 0;
+        for (int i = 0; i < m->file.rows; i++) {
+            for (int j = 0; j < m->file.cols; j++) {
+                length += m->lines[i][j] == '*';
+            }
+        }
+        return (int)length + 1;
+    }
+
+    maze_bitmap_clear(&m->visited);
+    maze_bitmap_clear(&m->path);
+    if (is_astar(solver, &heuristicKind)) {
+        heuristicLandmarks = &m->landmarks;
+        struct AStarContext *context = createAStarContext(&m->walls, openListKind);
+        int length = aStarQuery(context, m->start, m->goal);
+        *nodes = context->expanded;
+        if (length >= 0) {
+            for (int cell = context->parent[m->goal]; cell != m->start; cell = context->parent[cell]) {
+                maze_bit_set(&m->path, cell);
+            }
+            maze_bit_set(&m->path, m->start);
+        }
+        freeAStarContext(context);
+        return length < 0 ? -1 : length + 1;
+    }
+
+    if (strcmp(solver, "ao") == 0) {
+        struct ao_stats stats = { 0 };
+        int length = ao_search(&m->walls, m->start, m->goal, &m->path, &stats);
+        *nodes = stats.expanded;
+        return length < 0 ? -1 : length + 1;
+    }
+
+    int found = dfs_iterative(&m->walls, &m->visited, &m->path, m->start, m->goal, dfs_directions);
+    *nodes = count_bits(&m->visited);
+    return found == 1 ? (int)count_bits(&m->path) + 1 : -1;
+}
+
+// Write phase: the solution file each solver produces
+void write_solution(struct bench_maze *m, const char *solver, const char *path) {
+    if (strcmp(solver, "gitcode") == 0) {
+        // gitcode's own format: line and column counts, then the rows with '*' on the path
+        FILE *out = fopen(path, "w");
+        if (!out) {
+            printf("Error: Cannot create %s.\n", path);
+            exit(EXIT_FAILURE);
+        }
+        fprintf(out, "%d\n%d\n", m->file.rows, m->file.cols);
+        for (int i = 0; i < m->file.rows; i++) {
+            fwrite(m->lines[i], 1, m->file.cols, out);
+            fputc('\n', out);
+        }
+        fclose(out);
+    } else if (maze_write_marked(&m->file, &m->path, path) < 0) {
+        exit(EXIT_FAILURE);
+    }
+}
+
+// Run one solver on one maze file and fill result (in the solver's own process)
+void run_case(const char *maze_path, const char *solver, int warmup, int reps, struct bench_result *result) {
+    char out_path[4096];
+    snprintf(out_path, sizeof(out_path), "%s.%s.sol", maze_path, solver);
+    result->reps = reps;
+    for (int rep = -warmup; rep < reps; rep++) {
+        struct bench_maze m;
+        double t0 = now_seconds();
+        load_maze(&m, maze_path, solver);
+        double t1 = now_seconds();
+        result->path_length = solve_maze(&m, solver, &result->nodes);
+        double t2 = now_seconds();
+        write_solution(&m, solver, out_path);
+        double t3 = now_seconds();
+        unload_maze(&m);
+        if (rep >= 0) {
+            result->seconds[PHASE_LOAD][rep] = t1 - t0;
+            result->seconds[PHASE_SOLVE][rep] = t2 - t1;
+            result->seconds[PHASE_WRITE][rep] = t3 - t2;
+        }
+    }
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    result->peak_rss_kb = usage.ru_maxrss;
+}
+
+// Fork a process for the case, killed after timeout seconds, and read its result back through a pipe
+enum bench_status run_isolated(const char *maze_path, const char *solver, int warmup, int reps, int timeout,
+                               struct bench_result *result) {
+    int fds[2];
+    if (pipe(fds) < 0) {
+        printf("Error: Cannot create a pipe.\n");
+        exit(EXIT_FAILURE);
+    }
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0) {
+        printf("Error: Cannot fork.\n");
+        exit(EXIT_FAILURE);
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        alarm(timeout);
+        run_case(maze_path, solver, warmup, reps, result);
+        const char *data = (const char *)result;
+        size_t left = sizeof(*result);
+        while (left > 0) {
+            ssize_t n = write(fds[1], data, left);
+            if (n <= 0) {
+                _exit(1);
+            }
+            data += n;
+            left -= n;
+        }
+        _exit(0);
+    }
+
+    close(fds[1]);
+    char *data = (char *)result;
+    size_t got = 0;
+    ssize_t n;
+    while (got < sizeof(*result) && (n = read(fds[0], data + got, sizeof(*result) - got)) > 0) {
+        got += n;
+    }
+    close(fds[0]);
+    int status;
+    waitpid(pid, &status, 0);
+
+    // The solution file is left behind by every run, including a killed one
+    char out_path[4096];
+    snprintf(out_path, sizeof(out_path), "%s.%s.sol", maze_path, solver);
+    unlink(out_path);
+    if (WIFSIGNALED(status) && WTERMSIG(status) == SIGALRM) {
+        return CASE_TIMEOUT;
+    }
+    return got == sizeof(*result) && WIFEXITED(status) && WEXITSTATUS(status) == 0 ? CASE_OK : CASE_FAILED;
+}
+
+int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Function to compute the median and p95 (nearest rank) of a phase, in milliseconds
+void phase_stats(const struct bench_result *result, int phase, double *median, double *p95) {
+    double sorted[BENCH_MAX_REPS];
+    int n = result->reps;
+    memcpy(sorted, result->seconds[phase], n * sizeof(double));
+    qsort(sorted, n, sizeof(double), compare_doubles);
+    *median = 1e3 * (n % 2 ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2);
+    int rank = (95 * n + 99) / 100;
+    *p95 = 1e3 * sorted[rank - 1];
+}
+
+// Remove a generated maze and the cache files its solvers left next to it
+void remove_maze(const char *maze_path) {
+    unlink(maze_path);
+    char alt_path[4096];
+    landmarksPath(maze_path, ALT_DEFAULT_LANDMARKS, alt_path, sizeof(alt_path));
+    unlink(alt_path);
+}
+
+// Scaling check: solve perfect mazes of each size with every solver and print the solve time per
+// cell, flagging each solver whose time per cell grew by more than BENCH_SCALING_LIMIT between
+// two consecutive sizes
+void run_scaling(char *sizes[], int num_sizes, char *solvers[], int num_solvers, int warmup, int reps, int timeout,
+                 unsigned long long seed, struct bench_result *result) {
+    double solve_ms[BENCH_MAX_ITEMS][BENCH_MAX_ITEMS]; // size, solver; -1 if the case did not finish
+    int values[BENCH_MAX_ITEMS];
+    for (int z = 0; z < num_sizes; z++) {
+        values[z] = atoi(sizes[z]) | 1;
+        char maze_path[256];
+        snprintf(maze_path, sizeof(maze_path), "bench_scaling_%d_%llu.txt", values[z], seed);
+        generate_maze(maze_path, values[z], 0, seed);
+        for (int s = 0; s < num_solvers; s++) {
+            solve_ms[z][s] = -1;
+            if (run_isolated(maze_path, solvers[s], warmup, reps, timeout, result) == CASE_OK) {
+                double p95;
+                phase_stats(result, PHASE_SOLVE, &solve_ms[z][s], &p95);
+            }
+        }
+        remove_maze(maze_path);
+    }
+
+    printf("\nScaling on perfect mazes: solve ns per cell (-1: did not finish)\n%-8s", "solver");
+    for (int z = 0; z < num_sizes; z++) {
+        printf(" %10d", values[z]);
+    }
+    printf("\n");
+    for (int s = 0; s < num_solvers; s++) {
+        printf("%-8s", solvers[s]);
+        double worst = 0;
+        for (int z = 0; z < num_sizes; z++) {
+            double cells = (double)values[z] * values[z];
+            printf(" %10.2f", solve_ms[z][s] < 0 ? -1.0 : 1e6 * solve_ms[z][s] / cells);
+            if (z > 0 && solve_ms[z][s] >= 0 && solve_ms[z - 1][s] >= BENCH_SCALING_MIN_MS) {
+                double before = solve_ms[z - 1][s] / ((double)values[z - 1] * values[z - 1]);
+                double growth = solve_ms[z][s] / cells / before;
+                worst = growth > worst ? growth : worst;
+            }
+        }
+        if (worst > BENCH_SCALING_LIMIT) {
+            printf("  superlinear: %.1fx per cell", worst);
+        }
+        printf("\n");
+    }
+}
+
+// Split a comma-separated list in place
+int split_list(char *list, char *items[]) {
+    int count = 0;
+    for (char *item = strtok(list, ","); item && count < BENCH_MAX_ITEMS; item = strtok(NULL, ",")) {
+        items[count++] = item;
+    }
+    return count;
+}
+
+int main(int argc, char *argv[]) {
+    char sizes_arg[256] = "101,501,1001", types_arg[256] = "simple,obstacles", solvers_arg[256] = "dfs,astar,dijkstra,alt,ao,gitcode";
+    char scaling_arg[256] = "501,1001,2001";
+    int reps = 10, warmup = 2, timeout = 60;
+    unsigned long long seed = 1;
+    const char *csv_path = NULL, *json_path = NULL;
+    for (int i = 1; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--sizes") == 0 && has_value) {
+            snprintf(sizes_arg, sizeof(sizes_arg), "%s", argv[++i]);
+        } else if (strcmp(argv[i], "--types") == 0 && has_value) {
+            snprintf(types_arg, sizeof(types_arg), "%s", argv[++i]);
+        } else if (strcmp(argv[i], "--solvers") == 0 && has_value) {
+            snprintf(solvers_arg, sizeof(solvers_arg), "%s", argv[++i]);
+        } else if (strcmp(argv[i], "--reps") == 0 && has_value) {
+            reps = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--warmup") == 0 && has_value) {
+            warmup = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && has_value) {
+            seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--timeout") == 0 && has_value) {
+            timeout = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--csv") == 0 && has_value) {
+            csv_path = argv[++i];
+        } else if (strcmp(argv[i], "--json") == 0 && has_value) {
+            json_path = argv[++i];
+        } else if (strcmp(argv[i], "--scaling") == 0 && has_value) {
+            snprintf(scaling_arg, sizeof(scaling_arg), "%s", argv[++i]);
+        } else {
+            printf("Usage: %s [--sizes 101,501,1001] [--types simple,obstacles] [--solvers dfs,astar,dijkstra,alt,ao,gitcode]\n"
+                   "       [--reps 10] [--warmup 2] [--seed 1] [--timeout 60] [--csv file] [--json file]\n"
+                   "       [--scaling 501,1001,2001 | none]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (reps < 1 || reps > BENCH_MAX_REPS || warmup < 0 || timeout < 1) {
+        printf("Error: --reps must be 1..%d, --warmup at least 0 and --timeout at least 1.\n", BENCH_MAX_REPS);
+        return 1;
+    }
+
+    char *sizes[BENCH_MAX_ITEMS], *types[BENCH_MAX_ITEMS], *solvers[BENCH_MAX_ITEMS], *scaling[BENCH_MAX_ITEMS];
+    int num_sizes = split_list(sizes_arg, sizes);
+    int num_scaling = strcmp(scaling_arg, "none") == 0 ? 0 : split_list(scaling_arg, scaling);
+    int num_types = split_list(types_arg, types);
+    int num_solvers = split_list(solvers_arg, solvers);
+    for (int s = 0; s < num_solvers; s++) {
+        enum HeuristicKind kind;
+        if (strcmp(solvers[s], "dfs") && !is_astar(solvers[s], &kind) && strcmp(solvers[s], "ao") && strcmp(solvers[s], "gitcode")) {
+            printf("Error: Unknown solver %s (dfs, astar, dijkstra, alt, ao or gitcode).\n", solvers[s]);
+            return 1;
+        }
+    }
+    for (int z = 0; z < num_scaling; z++) {
+        if (atoi(scaling[z]) < 5) {
+            printf("Error: Maze size %s is too small.\n", scaling[z]);
+            return 1;
+        }
+    }
+    for (int t = 0; t < num_types; t++) {
+        if (strcmp(types[t], "simple") && strcmp(types[t], "obstacles")) {
+            printf("Error: Unknown maze type %s (simple or obstacles).\n", types[t]);
+            return 1;
+        }
+    }
+
+    FILE *csv = csv_path ? fopen(csv_path, "w") : NULL;
+    FILE *json = json_path ? fopen(json_path, "w") : NULL;
+    if ((csv_path && !csv) || (json_path && !json)) {
+        printf("Error: Cannot create the report files.\n");
+        return 1;
+    }
+    if (csv) {
+        fprintf(csv, "type,size,seed,solver,status,reps,load_median_ms,load_p95_ms,solve_median_ms,solve_p95_ms,"
+                     "write_median_ms,write_p95_ms,nodes,path_length,peak_rss_kb\n");
+    }
+    if (json) {
+        fprintf(json, "[");
+    }
+
+    printf("%-9s %6s %-8s %21s %21s %21s %10s %7s %9s\n", "type", "size", "solver",
+           "load ms (med/p95)", "solve ms (med/p95)", "write ms (med/p95)", "nodes", "path", "rss KB");
+    int records = 0;
+    struct bench_result *result = (struct bench_result *)malloc(sizeof(struct bench_result));
+    for (int t = 0; t < num_types; t++) {
+        for (int z = 0; z < num_sizes; z++) {
+            int size = atoi(sizes[z]) | 1; // Odd, like maze_generator
+            if (size < 5) {
+                printf("Error: Maze size %s is too small.\n", sizes[z]);
+                return 1;
+            }
+            char maze_path[256];
+            snprintf(maze_path, sizeof(maze_path), "bench_%s_%d_%llu.txt", types[t], size, seed);
+            generate_maze(maze_path, size, strcmp(types[t], "obstacles") == 0, seed);
+
+            for (int s = 0; s < num_solvers; s++) {
+                enum bench_status status = run_isolated(maze_path, solvers[s], warmup, reps, timeout, result);
+                if (status != CASE_OK) {
+                    printf("%-9s %6d %-8s %s\n", types[t], size, solvers[s],
+                           status == CASE_TIMEOUT ? "timed out" : "failed");
+                    if (csv) {
+                        fprintf(csv, "%s,%d,%llu,%s,%s,%d,,,,,,,,,\n", types[t], size, seed, solvers[s], status_names[status], reps);
+                    }
+                    if (json) {
+                        fprintf(json, "%s\n  {\"type\": \"%s\", \"size\": %d, \"seed\": %llu, \"solver\": \"%s\", \"status\": \"%s\"}",
+                                records ? "," : "", types[t], size, seed, solvers[s], status_names[status]);
+                    }
+                    records++;
+                    continue;
+                }
+                double median[PHASE_COUNT], p95[PHASE_COUNT];
+                for (int p = 0; p < PHASE_COUNT; p++) {
+                    phase_stats(result, p, &median[p], &p95[p]);
+                }
+                printf("%-9s %6d %-8s %10.3f/%-10.3f %10.3f/%-10.3f %10.3f/%-10.3f %10lld %7d %9ld\n",
+                       types[t], size, solvers[s], median[0], p95[0], median[1], p95[1], median[2], p95[2],
+                       result->nodes, result->path_length, result->peak_rss_kb);
+                if (csv) {
+                    fprintf(csv, "%s,%d,%llu,%s,ok,%d,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%lld,%d,%ld\n",
+                            types[t], size, seed, solvers[s], reps, median[0], p95[0], median[1], p95[1],
+                            median[2], p95[2], result->nodes, result->path_length, result->peak_rss_kb);
+                }
+                if (json) {
+                    fprintf(json, "%s\n  {\"type\": \"%s\", \"size\": %d, \"seed\": %llu, \"solver\": \"%s\", \"status\": \"ok\", \"reps\": %d",
+                            records ? "," : "", types[t], size, seed, solvers[s], reps);
+                    for (int p = 0; p < PHASE_COUNT; p++) {
+                        fprintf(json, ", \"%s_median_ms\": %.6f, \"%s_p95_ms\": %.6f",
+                                phase_names[p], median[p], phase_names[p], p95[p]);
+                    }
+                    fprintf(json, ", \"nodes\": %lld, \"path_length\": %d, \"peak_rss_kb\": %ld}",
+                            result->nodes, result->path_length, result->peak_rss_kb);
+                }
+                records++;
+            }
+            remove_maze(maze_path);
+        }
+    }
+    if (num_scaling > 0) {
+        run_scaling(scaling, num_scaling, solvers, num_solvers, warmup, reps, timeout, seed, result);
+    }
+    free(result);
+
+    if (csv) {
+        fclose(csv);
+    }
+    if (json) {
+        fprintf(json, "\n]\n");
+        fclose(json);
+    }
+    return 0;
+}
@@ -0,0 +1,92 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "maze_bits.h"
+
+#if defined(MAZE_SIMD_AVX2) || defined(MAZE_SIMD_SSE2)
+#include <immintrin.h>
+#endif
+
+// Allocate a cleared bitmap for a rows x cols maze, including the two guard rows
+void maze_bitmap_alloc(struct maze_bitmap* bits, int rows, int cols) {
+    bits->rows = rows;
+    bits->cols = cols;
+    bits->stride = maze_stride_for(cols);
+    bits->words_per_row = bits->stride / 64;
+    uint64_t* storage = (uint64_t*)calloc((size_t)(rows + 2) * bits->words_per_row, sizeof(uint64_t));
+    if (!storage) {
+        printf("Error: Cannot allocate a %d x %d bitmap.\n", rows, cols);
+        exit(EXIT_FAILURE);
+    }
+    bits->words = storage + bits->words_per_row;
+}
+
+void maze_bitmap_free(struct maze_bitmap* bits) {
+    if (bits->words) {
+        free(bits->words - bits->words_per_row);
+    }
+    bits->words = NULL;
+}
+
+void maze_bitmap_clear(struct maze_bitmap* bits) {
+    memset(bits->words, 0, (size_t)bits->rows * bits->words_per_row * sizeof(uint64_t));
+}
+
+// Set the guard rows and every padding column after the last real column
+void maze_bitmap_seal(struct maze_bitmap* bits) {
+    int row_words = bits->words_per_row;
+    memset(bits->words - row_words, 0xFF, row_words * sizeof(uint64_t));
+    memset(bits->words + (size_t)bits->rows * row_words, 0xFF, row_words * sizeof(uint64_t));
+    for (int row = 0; row < bits->rows; row++) {
+        for (int col = bits->cols; col < bits->stride; col++) {
+            maze_bit_set(bits, maze_bit_index(bits, row, col));
+        }
+    }
+}
+
+void maze_bitmap_from_grid(struct maze_bitmap* bits, const struct maze_grid* grid, char value) {
+    maze_bitmap_alloc(bits, grid->rows, grid->cols);
+    for (int row = 0; row < grid->rows; row++) {
+        maze_bits_pack_row(bits->words + (size_t)row * bits->words_per_row, maze_row(grid, row), grid->cols, value);
+    }
+    maze_bitmap_seal(bits);
+}
+
+// Each compare turns a block of cells into a byte mask and movemask packs its top bits, so a
+// 64-cell word takes two AVX2 or four SSE2 compares; the rest of the row goes one cell at a time
+void maze_bits_pack_row(uint64_t* words, const char* cells, int cols, char value) {
+    int col = 0;
+#if defined(MAZE_SIMD_AVX2)
+    const __m256i needle = _mm256_set1_epi8(value);
+    for (; col + 64 <= cols; col += 64) {
+        uint32_t low = (uint32_t)_mm256_movemask_epi8(
+            _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(cells + col)), needle));
+        uint32_t high = (uint32_t)_mm256_movemask_epi8(
+            _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(cells + col + 32)), needle));
+        words[col >> 6] = (uint64_t)low | (uint64_t)high << 32;
+    }
+#elif defined(MAZE_SIMD_SSE2)
+    const __m128i needle = _mm_set1_epi8(value);
+    for (; col + 64 <= cols; col += 64) {
+        uint64_t word = 0;
+        for (int part = 0; part < 4; part++) {
+            __m128i block = _mm_loadu_si128((const __m128i*)(cells + col + 16 * part));
+            word |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle)) << (16 * part);
+        }
+        words[col >> 6] = word;
+    }
+#endif
+    for (; col < cols; col++) {
+        words[col >> 6] |= (uint64_t)(cells[col] == value) << (col & 63);
+    }
+}
+
+const char* maze_simd_name(void) {
+#if defined(MAZE_SIMD_AVX2)
+    return "avx2";
+#elif defined(MAZE_SIMD_SSE2)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,79 @@
+#ifndef MAZE_BITS_H
+#define MAZE_BITS_H
+
+#include <stdint.h>
+#include "maze_core.h"
+
+// Row kernels are vectorised at compile time: AVX2 when the compiler targets it (-mavx2 or
+// -march=native), SSE2 on any other x86-64 build, plain C elsewhere or with -DMAZE_NO_SIMD
+#if !defined(MAZE_NO_SIMD) && defined(__AVX2__)
+#define MAZE_SIMD_AVX2 1
+#elif !defined(MAZE_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64))
+#define MAZE_SIMD_SSE2 1
+#endif
+
+// One bit per cell, 64 cells per word, addressed by the same linear index as struct maze_grid.
+// Rows start on word boundaries (the stride is a multiple of 64) and the storage has one guard
+// row above and below the maze, so index - 1, + 1, - stride and + stride are always in range
+// for any cell of the maze. A sealed bitmap has its guard rows and padding columns set, which
+// lets a wall bitmap answer neighbour tests without separate bounds checks.
+struct maze_bitmap {
+    int rows;
+    int cols;
+    int stride;
+    int words_per_row;
+    uint64_t* words;    // Points at row 0; the guard rows sit just before and after
+};
+
+void maze_bitmap_alloc(struct maze_bitmap* bits, int rows, int cols);
+void maze_bitmap_free(struct maze_bitmap* bits);
+void maze_bitmap_clear(struct maze_bitmap* bits);
+void maze_bitmap_seal(struct maze_bitmap* bits);
+
+// Build a sealed bitmap with a bit set for every cell of grid equal to value
+void maze_bitmap_from_grid(struct maze_bitmap* bits, const struct maze_grid* grid, char value);
+
+// Set the bit of every cell in cells[0..cols) equal to value in one bitmap row (words must be
+// clear). Compares 32 or 16 cells per instruction and stores whole words.
+void maze_bits_pack_row(uint64_t* words, const char* cells, int cols, char value);
+
+// Name of the row kernels compiled in: "avx2", "sse2" or "scalar"
+const char* maze_simd_name(void);
+
+static inline int maze_bit_test(const struct maze_bitmap* bits, int index) {
+    return (int)((bits->words[index >> 6] >> (index & 63)) & 1);
+}
+
+static inline void maze_bit_set(struct maze_bitmap* bits, int index) {
+    bits->words[index >> 6] |= (uint64_t)1 << (index & 63);
+}
+
+static inline void maze_bit_clear(struct maze_bitmap* bits, int index) {
+    bits->words[index >> 6] &= ~((uint64_t)1 << (index & 63));
+}
+
+static inline int maze_bit_index(const struct maze_bitmap* bits, int row, int col) {
+    return row * bits->stride + col;
+}
+
+// Bytes allocated for the bitmap, guard rows included
+static inline long long maze_bitmap_bytes(const struct maze_bitmap* bits) {
+    return (long long)(bits->rows + 2) * bits->words_per_row * sizeof(uint64_t);
+}
+
+// Bits 0..3 of the result are set for the up, down, left and right neighbours of index that
+// are clear in both bitmaps (open and not yet visited). Up and down are the same bit in the
+// words one row away; left and right only cross a word at the ends of a word.
+static inline unsigned maze_bits_open_neighbors(const struct maze_bitmap* walls, const struct maze_bitmap* visited, int index) {
+    int word = index >> 6, bit = index & 63, row_words = walls->words_per_row;
+    uint64_t up = walls->words[word - row_words] | visited->words[word - row_words];
+    uint64_t down = walls->words[word + row_words] | visited->words[word + row_words];
+    int left = index - 1, right = index + 1;
+    unsigned blocked = (unsigned)((up >> bit) & 1)
+        | (unsigned)((down >> bit) & 1) << 1
+        | (unsigned)((maze_bit_test(walls, left) | maze_bit_test(visited, left)) << 2)
+        | (unsigned)((maze_bit_test(walls, right) | maze_bit_test(visited, right)) << 3);
+    return ~blocked & 0xFu;
+}
+
+#endif
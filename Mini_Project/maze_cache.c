@@ -0,0 +1,196 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "maze_cache.h"
+#include "maze_io.h"
+
+void maze_cache_init(struct maze_cache *cache, int capacity) {
+    pthread_mutex_init(&cache->lock, NULL);
+    cache->head = cache->tail = NULL;
+    cache->count = 0;
+    cache->capacity = capacity < 1 ? 1 : capacity;
+    cache->hits = cache->misses = cache->evictions = 0;
+}
+
+static void free_entry(struct cached_maze *entry) {
+    for (int i = 0; i < entry->idle_count; i++) {
+        freeAStarContext(entry->idle[i]);
+    }
+    free(entry->idle);
+    maze_bitmap_free(&entry->walls);
+    freeLandmarks(&entry->landmarks);
+    free(entry->path);
+    free(entry);
+}
+
+// Unlink an entry from the LRU list; it is freed now or by its last user. Called with the lock held.
+static void drop_entry(struct maze_cache *cache, struct cached_maze *entry) {
+    if (entry->prev) {
+        entry->prev->next = entry->next;
+    } else {
+        cache->head = entry->next;
+    }
+    if (entry->next) {
+        entry->next->prev = entry->prev;
+    } else {
+        cache->tail = entry->prev;
+    }
+    cache->count--;
+    entry->dropped = true;
+    if (entry->refs == 0) {
+        free_entry(entry);
+    }
+}
+
+// Move an entry to the front of the LRU list. Called with the lock held.
+static void push_front(struct maze_cache *cache, struct cached_maze *entry) {
+    entry->prev = NULL;
+    entry->next = cache->head;
+    if (cache->head) {
+        cache->head->prev = entry;
+    } else {
+        cache->tail = entry;
+    }
+    cache->head = entry;
+}
+
+static struct cached_maze *find_entry(struct maze_cache *cache, const char *path) {
+    for (struct cached_maze *entry = cache->head; entry; entry = entry->next) {
+        if (strcmp(entry->path, path) == 0) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+static bool same_version(const struct cached_maze *entry, const struct stat *st) {
+    return entry->size == st->st_size && entry->mtime.tv_sec == st->st_mtim.tv_sec &&
+           entry->mtime.tv_nsec == st->st_mtim.tv_nsec;
+}
+
+// Read a maze file into a new entry (outside the lock)
+static struct cached_maze *load_entry(const char *path, const struct stat *st) {
+    struct maze_file file;
+    if (maze_file_open(&file, path) < 0) {
+        return NULL;
+    }
+    struct cached_maze *entry = (struct cached_maze *)calloc(1, sizeof(struct cached_maze));
+    if (!entry || !(entry->path = strdup(path))) {
+        printf("Error: Cannot allocate a cache entry.\n");
+        exit(EXIT_FAILURE);
+    }
+    entry->mtime = st->st_mtim;
+    entry->size = st->st_size;
+    entry->rows = file.rows;
+    entry->cols = file.cols;
+    maze_file_to_bitmap(&file, &entry->walls, 'x');
+    entry->start = file.start_row < 0 ? -1 : maze_bit_index(&entry->walls, file.start_row, file.start_col);
+    entry->goal = file.goal_row < 0 ? -1 : maze_bit_index(&entry->walls, file.goal_row, file.goal_col);
+    maze_file_close(&file);
+
+    // ALT landmark tables are cached next to the maze like everywhere else
+    if (heuristicNeedsLandmarks(heuristicKind) &&
+        prepareLandmarks(&entry->landmarks, path, &entry->walls, ALT_DEFAULT_LANDMARKS) < 0) {
+        free_entry(entry);
+        return NULL;
+    }
+    return entry;
+}
+
+struct cached_maze *maze_cache_get(struct maze_cache *cache, const char *path) {
+    struct stat st;
+    if (stat(path, &st) < 0) {
+        printf("Error: Cannot read file %s.\n", path);
+        return NULL;
+    }
+
+    pthread_mutex_lock(&cache->lock);
+    struct cached_maze *entry = find_entry(cache, path);
+    if (entry && same_version(entry, &st)) {
+        cache->hits++;
+    } else {
+        // Load without holding the lock so other mazes keep being served
+        cache->misses++;
+        pthread_mutex_unlock(&cache->lock);
+        struct cached_maze *loaded = load_entry(path, &st);
+        if (!loaded) {
+            return NULL;
+        }
+        pthread_mutex_lock(&cache->lock);
+        entry = find_entry(cache, path);
+        if (entry && same_version(entry, &st)) {
+            free_entry(loaded); // Another thread loaded the same version first
+        } else {
+            if (entry) {
+                drop_entry(cache, entry); // Stale version
+            }
+            entry = loaded;
+            push_front(cache, entry);
+            cache->count++;
+            while (cache->count > cache->capacity) {
+                drop_entry(cache, cache->tail);
+                cache->evictions++;
+            }
+        }
+    }
+
+    // Mark as most recently used
+    if (cache->head != entry) {
+        entry->prev->next = entry->next;
+        if (entry->next) {
+            entry->next->prev = entry->prev;
+        } else {
+            cache->tail = entry->prev;
+        }
+        push_front(cache, entry);
+    }
+    entry->refs++;
+    pthread_mutex_unlock(&cache->lock);
+    return entry;
+}
+
+void maze_cache_release(struct maze_cache *cache, struct cached_maze *entry) {
+    pthread_mutex_lock(&cache->lock);
+    if (--entry->refs == 0 && entry->dropped) {
+        free_entry(entry);
+    }
+    pthread_mutex_unlock(&cache->lock);
+}
+
+struct AStarContext *maze_cache_borrow(struct maze_cache *cache, struct cached_maze *entry) {
+    struct AStarContext *context = NULL;
+    pthread_mutex_lock(&cache->lock);
+    if (entry->idle_count > 0) {
+        context = entry->idle[--entry->idle_count];
+    }
+    pthread_mutex_unlock(&cache->lock);
+    if (!context) {
+        context = createAStarContext(&entry->walls, openListKind);
+        context->landmarks = &entry->landmarks;
+    }
+    return context;
+}
+
+void maze_cache_return(struct maze_cache *cache, struct cached_maze *entry, struct AStarContext *context) {
+    pthread_mutex_lock(&cache->lock);
+    if (entry->idle_count == entry->idle_capacity) {
+        entry->idle_capacity = entry->idle_capacity ? entry->idle_capacity * 2 : 4;
+        entry->idle = (struct AStarContext **)realloc(entry->idle, entry->idle_capacity * sizeof(struct AStarContext *));
+        if (!entry->idle) {
+            printf("Error: Cannot allocate a cache entry.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    entry->idle[entry->idle_count++] = context;
+    pthread_mutex_unlock(&cache->lock);
+}
+
+void maze_cache_destroy(struct maze_cache *cache) {
+    pthread_mutex_lock(&cache->lock);
+    while (cache->head) {
+        drop_entry(cache, cache->head);
+    }
+    pthread_mutex_unlock(&cache->lock);
+    pthread_mutex_destroy(&cache->lock);
+}
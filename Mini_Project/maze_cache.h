@@ -0,0 +1,50 @@
+#ifndef MAZE_CACHE_H
+#define MAZE_CACHE_H
+
+#include <stdbool.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <time.h>
+#include "maze_bits.h"
+#include "Astar_code.h"
+
+// A maze kept resident by the cache: its wall bitmap plus a pool of A* contexts that queries
+// borrow, so neither the file nor the search state is reloaded or reallocated per query.
+// Entries are keyed by path and the file's modification time and size; an edited file is
+// loaded again on its next lookup.
+struct cached_maze {
+    char *path;
+    struct timespec mtime;
+    off_t size;
+    int rows, cols;
+    int start, goal;                 // Cells of 's' and 'g' in the bitmap, -1 if absent
+    struct maze_bitmap walls;
+    struct Landmarks landmarks;      // ALT tables, when heuristicKind needs them
+    struct AStarContext **idle;      // Contexts not in use by any query
+    int idle_count, idle_capacity;
+    int refs;                        // Lookups not yet released
+    bool dropped;                    // No longer in the cache; freed by the last release
+    struct cached_maze *prev, *next; // LRU list, most recently used first
+};
+
+struct maze_cache {
+    pthread_mutex_t lock;
+    struct cached_maze *head, *tail;
+    int count, capacity;
+    long long hits, misses, evictions;
+};
+
+void maze_cache_init(struct maze_cache *cache, int capacity);
+void maze_cache_destroy(struct maze_cache *cache);
+
+// Return the entry for path, loading it on a miss or when the file changed. The entry stays
+// valid until maze_cache_release, even if it is evicted meanwhile. Returns NULL if the file
+// cannot be read.
+struct cached_maze *maze_cache_get(struct maze_cache *cache, const char *path);
+void maze_cache_release(struct maze_cache *cache, struct cached_maze *entry);
+
+// Borrow an A* context for the entry (allocated on first use) and give it back
+struct AStarContext *maze_cache_borrow(struct maze_cache *cache, struct cached_maze *entry);
+void maze_cache_return(struct maze_cache *cache, struct cached_maze *entry, struct AStarContext *context);
+
+#endif
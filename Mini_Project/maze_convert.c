@@ -0,0 +1,48 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "maze_core.h"
+#include "maze_io.h"
+
+// Convert a maze between the text format and the binary .mzb format.
+// The input format is detected from the file; the output format follows the arguments:
+//   maze_convert maze.txt maze.mzb [byte|bits]   text (or .mzb) to .mzb
+//   maze_convert maze.mzb maze.txt text          .mzb (or text) to text
+int main(int argc, char* argv[]) {
+    if (argc < 3 || argc > 4) {
+        printf("Usage: %s <input> <output> [text|byte|bits]\n", argv[0]);
+        return 1;
+    }
+
+    // Default: .mzb files get the bit encoding, anything else is written as text
+    const char* format = argc == 4 ? argv[3] : (strstr(argv[2], ".mzb") ? "bits" : "text");
+    if (strcmp(format, "text") != 0 && strcmp(format, "byte") != 0 && strcmp(format, "bits") != 0) {
+        printf("Error: Unknown format '%s'.\n", format);
+        return 1;
+    }
+
+    struct maze_file file;
+    if (maze_file_open(&file, argv[1]) < 0) {
+        return 1;
+    }
+    struct maze_grid grid;
+    maze_file_to_grid(&file, &grid);
+    int start_row = file.start_row, start_col = file.start_col;
+    int goal_row = file.goal_row, goal_col = file.goal_col;
+    maze_file_close(&file);
+
+    int status;
+    if (strcmp(format, "text") == 0) {
+        status = maze_write_grid(&grid, argv[2], 1);
+    } else {
+        enum mzb_encoding encoding = strcmp(format, "byte") == 0 ? MZB_ENCODING_BYTE : MZB_ENCODING_BITS;
+        status = maze_write_mzb(&grid, argv[2], encoding, start_row, start_col, goal_row, goal_col);
+    }
+    maze_grid_free(&grid);
+
+    if (status < 0) {
+        return 1;
+    }
+    printf("Converted %s to %s (%s, %d x %d).\n", argv[1], argv[2], format, grid.rows, grid.cols);
+    return 0;
+}
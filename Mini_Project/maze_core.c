@@ -0,0 +1,31 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "maze_core.h"
+
+// Allocate a zeroed rows x cols grid with a single allocation
+void maze_grid_alloc(struct maze_grid* grid, int rows, int cols) {
+    grid->rows = rows;
+    grid->cols = cols;
+    grid->stride = maze_stride_for(cols);
+    grid->cells = (char*)calloc((size_t)rows * grid->stride, 1);
+    if (!grid->cells) {
+        printf("Error: Cannot allocate a %d x %d maze.\n", rows, cols);
+        exit(EXIT_FAILURE);
+    }
+}
+
+void maze_grid_free(struct maze_grid* grid) {
+    free(grid->cells);
+    grid->cells = NULL;
+}
+
+void maze_grid_fill(struct maze_grid* grid, char value) {
+    memset(grid->cells, value, (size_t)grid->rows * grid->stride);
+}
+
+void maze_neighbor_offsets(int stride, const int directions[4][2], int offsets[4]) {
+    for (int i = 0; i < 4; i++) {
+        offsets[i] = directions[i][0] * stride + directions[i][1];
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef MAZE_CORE_H
+#define MAZE_CORE_H
+
+// Shared maze grid: one contiguous row-major buffer of bytes. Cell (row, col) lives at
+// cells[row * stride + col]; the same linear index is used for every per-cell array
+// (visited states, A* details, parents, ...), so neighbours are a fixed offset away.
+// The stride is rounded up past cols to a multiple of 64, so every row starts on a
+// 64-bit word boundary in the bitmaps of maze_bits.h and each row has padding cells.
+struct maze_grid {
+    int rows;
+    int cols;
+    int stride;    // Distance in cells between vertically adjacent cells
+    char* cells;
+};
+
+static inline int maze_stride_for(int cols) {
+    return (cols + 1 + 63) / 64 * 64;
+}
+
+void maze_grid_alloc(struct maze_grid* grid, int rows, int cols);
+void maze_grid_free(struct maze_grid* grid);
+void maze_grid_fill(struct maze_grid* grid, char value);
+
+static inline int maze_index(const struct maze_grid* grid, int row, int col) {
+    return row * grid->stride + col;
+}
+
+static inline int maze_row_of(const struct maze_grid* grid, int index) {
+    return index / grid->stride;
+}
+
+static inline int maze_col_of(const struct maze_grid* grid, int index) {
+    return index % grid->stride;
+}
+
+static inline char* maze_row(const struct maze_grid* grid, int row) {
+    return grid->cells + (long)row * grid->stride;
+}
+
+static inline int maze_in_bounds(const struct maze_grid* grid, int row, int col) {
+    return row >= 0 && row < grid->rows && col >= 0 && col < grid->cols;
+}
+
+// Convert (row, col) direction offsets into linear index offsets for grids with this stride
+void maze_neighbor_offsets(int stride, const int directions[4][2], int offsets[4]);
+
+#endif
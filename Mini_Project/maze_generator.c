@@ -1,27 +1,50 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdatomic.h>
 #include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "maze_core.h"
+#include "maze_io.h"
+#include "maze_bits.h"
+#include "maze_labels.h"
 
 #define WALL 'x'
 #define PATH ' '
 #define START 's' // start of the maze
 #define GOAL 'g' // goal point of maze
 
+#define TILE_CELLS 128 // Edge of a parallel generation tile, in maze cells
+
 // Directions: up, down, left, right
-int dx[] = {0, 0, -2, 2};
-int dy[] = {-2, 2, 0, 0};
+const int dx[] = {0, 0, -2, 2};
+const int dy[] = {-2, 2, 0, 0};
+
+// All 24 orders in which the four directions can be tried; each carved cell picks one at random
+const unsigned char directionOrders[24][4] = {
+    {0, 1, 2, 3}, {0, 1, 3, 2}, {0, 2, 1, 3}, {0, 2, 3, 1}, {0, 3, 1, 2}, {0, 3, 2, 1},
+    {1, 0, 2, 3}, {1, 0, 3, 2}, {1, 2, 0, 3}, {1, 2, 3, 0}, {1, 3, 0, 2}, {1, 3, 2, 0},
+    {2, 0, 1, 3}, {2, 0, 3, 1}, {2, 1, 0, 3}, {2, 1, 3, 0}, {2, 3, 0, 1}, {2, 3, 1, 0},
+    {3, 0, 1, 2}, {3, 0, 2, 1}, {3, 1, 0, 2}, {3, 1, 2, 0}, {3, 2, 0, 1}, {3, 2, 1, 0}
+};
 
 // Function prototypes
-void initializeMaze(char **maze, int rows, int cols);
-void carvePath(char **maze, int rows, int cols, int x, int y);
-void placeStartAndGoal(char **maze, int rows, int cols, int *startRow, int *startCol, int *goalRow, int *goalCol);
-void writeMazeToFile(char **maze, int rows, int cols, const char *filename);
-void generateMazeWithObstacles(char **maze, int rows, int cols, int obstacleCount);
-char **allocateMaze(int rows, int cols);
+void initializeMaze(struct maze_grid *maze);
+void carvePath(struct maze_grid *maze, int x, int y);
+void carveRegion(struct maze_grid *maze, int x, int y, int rowLo, int rowHi, int colLo, int colHi,
+                 unsigned long long *stream);
+double carveTiled(struct maze_grid *maze, int threads);
+void placeStartAndGoal(struct maze_grid *maze, int *startRow, int *startCol, int *goalRow, int *goalCol);
+void writeMazeToFile(const struct maze_grid *maze, const char *filename);
+void generateMazeWithObstacles(struct maze_grid *maze, int obstacleCount);
+void generateStreamingMaze(int rows, int cols, const char *filename);
+void labelMaze(const struct maze_grid *maze, const char *filename, int startRow, int startCol, int goalRow, int goalCol);
 
 int main() {
     int rows, cols;
-    char **maze;
+    struct maze_grid maze;
 
     printf("Enter maze dimensions (rows cols): ");
     scanf("%d %d", &rows, &cols);
@@ -30,10 +53,6 @@ int main() {
     if (rows % 2 == 0) rows++;
     if (cols % 2 == 0) cols++;
 
-    // Allocate and initialize the maze
-    maze = allocateMaze(rows, cols);
-    initializeMaze(maze, rows, cols);
-
     // Seed the random number generator
     srand(time(NULL));
 
@@ -41,123 +60,490 @@ int main() {
     printf("Choose the type of maze to generate:\n");
     printf("1. Simple Maze\n");
     printf("2. Maze with Obstacles\n");
+    printf("3. Streaming Maze (written row by row, for mazes larger than memory)\n");
+    printf("4. Parallel Tiled Maze (tiles carved on several threads, then stitched)\n");
     printf("Enter your choice: ");
     scanf("%d", &choice);
 
+    // The streaming generator never holds the grid, so it skips the allocation below
+    if (choice == 3) {
+        generateStreamingMaze(rows, cols, "maze.txt");
+        printf("Maze generated and saved to 'maze.txt'.\n");
+        return 0;
+    }
+
+    // Allocate and initialize the maze
+    maze_grid_alloc(&maze, rows, cols);
+    initializeMaze(&maze);
+
     // Generate the chosen type of maze
     if (choice == 1) {
-        carvePath(maze, rows, cols, 1, 1);
+        carvePath(&maze, 1, 1);
+    } else if (choice == 4) {
+        int threads = 0;
+        printf("Enter the number of threads (0 to compare 1, 2, 4, ... up to the CPU count): ");
+        if (scanf("%d", &threads) != 1 || threads < 0) {
+            threads = 0;
+        }
+        if (threads > 0) {
+            carveTiled(&maze, threads);
+        } else {
+            long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+            for (int t = 1; t <= (cpus > 1 ? cpus : 1); t *= 2) {
+                if (t > 1) {
+                    initializeMaze(&maze);
+                }
+                carveTiled(&maze, t);
+            }
+        }
     } else if (choice == 2) {
-        carvePath(maze, rows, cols, 1, 1);
+        carvePath(&maze, 1, 1);
         int obstacleCount = (rows * cols) / 10; // Example: 10% of the cells will be obstacles
-        generateMazeWithObstacles(maze, rows, cols, obstacleCount);
+        generateMazeWithObstacles(&maze, obstacleCount);
     } else {
         printf("Invalid choice! Generating a simple maze by default.\n");
-        carvePath(maze, rows, cols, 1, 1);
+        carvePath(&maze, 1, 1);
     }
 
     // Place start ('s') and goal ('g') in the maze
     int startRow, startCol, goalRow, goalCol;
-    placeStartAndGoal(maze, rows, cols, &startRow, &startCol, &goalRow, &goalCol);
+    placeStartAndGoal(&maze, &startRow, &startCol, &goalRow, &goalCol);
+
+    // Choose the output format; anything unreadable keeps the text format
+    int format = 1;
+    printf("Choose the output format:\n");
+    printf("1. Text (maze.txt)\n");
+    printf("2. Binary, one byte per cell (maze.mzb)\n");
+    printf("3. Binary, one bit per cell (maze.mzb)\n");
+    printf("Enter your choice: ");
+    if (scanf("%d", &format) != 1) {
+        format = 1;
+    }
 
     // Write the generated maze to a file
-    writeMazeToFile(maze, rows, cols, "maze.txt");
+    const char *filename = format == 2 || format == 3 ? "maze.mzb" : "maze.txt";
+    if (format == 2 || format == 3) {
+        enum mzb_encoding encoding = format == 2 ? MZB_ENCODING_BYTE : MZB_ENCODING_BITS;
+        if (maze_write_mzb(&maze, filename, encoding, startRow, startCol, goalRow, goalCol) < 0) {
+            exit(EXIT_FAILURE);
+        }
+    } else {
+        writeMazeToFile(&maze, filename);
+    }
+    printf("Maze generated and saved to '%s'.\n", filename);
 
-    printf("Maze generated and saved to 'maze.txt'.\n");
+    // The label map costs an int per cell on disk and a parallel array while it is built, so it
+    // is only made on request; solve_maze --batch builds it on first use otherwise
+    int label = 0;
+    printf("Label the connected areas and cache them next to the maze? (1 = yes, 0 = no): ");
+    if (scanf("%d", &label) == 1 && label == 1) {
+        labelMaze(&maze, filename, startRow, startCol, goalRow, goalCol);
+    }
 
     // Free allocated memory
-    for (int i = 0; i < rows; i++) {
-        free(maze[i]);
-    }
-    free(maze);
+    maze_grid_free(&maze);
 
     return 0;
 }
 
-// Allocate memory for the maze
-char **allocateMaze(int rows, int cols) {
-    char **maze = (char **)malloc(rows * sizeof(char *));
-    for (int i = 0; i < rows; i++) {
-        maze[i] = (char *)malloc(cols * sizeof(char));
+// Initialize the maze with walls
+void initializeMaze(struct maze_grid *maze) {
+    maze_grid_fill(maze, WALL);
+}
+
+// Random number in [0, bound): rand() when stream is NULL, otherwise the next splitmix64 value
+// of a private stream, so tiles carved on different threads never share generator state
+static int nextRandom(unsigned long long *stream, int bound) {
+    if (!stream) {
+        return rand() % bound;
     }
-    return maze;
+    unsigned long long z = (*stream += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return (int)((z ^ (z >> 31)) % (unsigned long long)bound);
 }
 
-// Initialize the maze with walls
-void initializeMaze(char **maze, int rows, int cols) {
-    for (int i = 0; i < rows; i++) {
-        for (int j = 0; j < cols; j++) {
-            maze[i][j] = WALL;
+// Carve paths in the maze with an iterative backtracker
+void carvePath(struct maze_grid *maze, int x, int y) {
+    carveRegion(maze, x, y, 0, maze->rows, 0, maze->cols, NULL);
+}
+
+// Carve a perfect maze inside the open box rowLo < row < rowHi, colLo < col < colHi. Each stack
+// frame is a cell index plus one state byte (direction order * 4 + next position in that order),
+// so memory grows with the grid instead of the thread stack.
+void carveRegion(struct maze_grid *maze, int x, int y, int rowLo, int rowHi, int colLo, int colHi,
+                 unsigned long long *stream) {
+    char *cells = maze->cells;
+
+    // Linear offsets of the cell two steps away and of the wall in between, per direction
+    int offsets[4], wallOffsets[4];
+    for (int i = 0; i < 4; i++) {
+        offsets[i] = dx[i] * maze->stride + dy[i];
+        wallOffsets[i] = offsets[i] / 2;
+    }
+
+    int capacity = 1024, size = 0;
+    int *stack = (int *)malloc(capacity * sizeof(int));
+    unsigned char *states = (unsigned char *)malloc(capacity * sizeof(unsigned char));
+    if (!stack || !states) {
+        printf("Error: Cannot allocate the carving stack.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    cells[maze_index(maze, x, y)] = PATH;
+    stack[size] = maze_index(maze, x, y);
+    states[size] = (unsigned char)(nextRandom(stream, 24) * 4);
+    size++;
+
+    while (size > 0) {
+        int cell = stack[size - 1];
+        int order = states[size - 1] / 4;
+        int next = states[size - 1] % 4;
+        int curX = maze_row_of(maze, cell), curY = maze_col_of(maze, cell);
+
+        // The last direction of a frame needs nothing after it, so drop the frame before descending
+        if (next == 3) {
+            size--;
+        } else {
+            states[size - 1]++;
         }
+
+        int dir = directionOrders[order][next];
+        int newX = curX + dx[dir];
+        int newY = curY + dy[dir];
+
+        if (newX > rowLo && newX < rowHi && newY > colLo && newY < colHi && cells[cell + offsets[dir]] == WALL) {
+            cells[cell + wallOffsets[dir]] = PATH; // Carve through the wall
+            cells[cell + offsets[dir]] = PATH;
+
+            if (size == capacity) {
+                capacity *= 2;
+                int *grownStack = (int *)realloc(stack, capacity * sizeof(int));
+                unsigned char *grownStates = (unsigned char *)realloc(states, capacity * sizeof(unsigned char));
+                if (!grownStack || !grownStates) {
+                    printf("Error: Cannot grow the carving stack.\n");
+                    exit(EXIT_FAILURE);
+                }
+                stack = grownStack;
+                states = grownStates;
+            }
+            stack[size] = cell + offsets[dir];
+            states[size] = (unsigned char)(nextRandom(stream, 24) * 4);
+            size++;
+        }
+    }
+
+    free(stack);
+    free(states);
+}
+
+// Find the set representative, halving paths on the way
+static int findSet(int *parent, int c) {
+    while (parent[c] != c) {
+        parent[c] = parent[parent[c]];
+        c = parent[c];
     }
+    return c;
 }
 
-// Recursive function to carve paths in the maze
-void carvePath(char **maze, int rows, int cols, int x, int y) {
-    maze[x][y] = PATH;
+// Work shared by the tile carving threads: tiles are handed out through an atomic counter
+struct TileJob {
+    struct maze_grid *maze;
+    int cellRows, cellCols;   // Maze cells (odd grid positions) in each direction
+    int tileRows, tileCols;   // Tiles in each direction
+    unsigned long long seed;  // Base of the per-tile random streams
+    atomic_int nextTile;
+};
 
-    // Shuffle directions for randomness
-    for (int i = 0; i < 4; i++) {
-        int r = rand() % 4;
-        int tempX = dx[i], tempY = dy[i];
-        dx[i] = dx[r], dy[i] = dy[r];
-        dx[r] = tempX, dy[r] = tempY;
+// Thread body: carve whole tiles until none are left
+static void *carveTiles(void *arg) {
+    struct TileJob *job = (struct TileJob *)arg;
+    int tileCount = job->tileRows * job->tileCols;
+    for (int t = atomic_fetch_add(&job->nextTile, 1); t < tileCount; t = atomic_fetch_add(&job->nextTile, 1)) {
+        int firstRow = (t / job->tileCols) * TILE_CELLS, firstCol = (t % job->tileCols) * TILE_CELLS;
+        int lastRow = firstRow + TILE_CELLS < job->cellRows ? firstRow + TILE_CELLS : job->cellRows;
+        int lastCol = firstCol + TILE_CELLS < job->cellCols ? firstCol + TILE_CELLS : job->cellCols;
+
+        // The stream depends only on the tile, so the maze does not change with the thread count
+        unsigned long long stream = job->seed + (unsigned long long)t * 0xD1B54A32D192ED03ULL;
+        carveRegion(job->maze, 2 * firstRow + 1, 2 * firstCol + 1, 2 * firstRow, 2 * lastRow,
+                    2 * firstCol, 2 * lastCol, &stream);
     }
+    return NULL;
+}
 
-    for (int i = 0; i < 4; i++) {
-        int newX = x + dx[i];
-        int newY = y + dy[i];
-        int betweenX = x + dx[i] / 2;
-        int betweenY = y + dy[i] / 2;
+// Carve the maze as independent tiles on several threads, then stitch the tiles together:
+// seams between neighbouring tiles are visited in random order and one wall is opened whenever
+// the two tiles are not yet connected (union-find over tiles), so the maze stays a single
+// spanning tree. Prints and returns the throughput in grid cells per second.
+double carveTiled(struct maze_grid *maze, int threads) {
+    struct timespec begin, end;
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+
+    struct TileJob job;
+    job.maze = maze;
+    job.cellRows = (maze->rows - 1) / 2;
+    job.cellCols = (maze->cols - 1) / 2;
+    job.tileRows = (job.cellRows + TILE_CELLS - 1) / TILE_CELLS;
+    job.tileCols = (job.cellCols + TILE_CELLS - 1) / TILE_CELLS;
+    job.seed = ((unsigned long long)rand() << 32) ^ (unsigned long long)rand();
+    atomic_init(&job.nextTile, 0);
+
+    pthread_t *workers = (pthread_t *)malloc(threads * sizeof(pthread_t));
+    if (!workers) {
+        printf("Error: Cannot allocate the worker threads.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < threads; i++) {
+        if (pthread_create(&workers[i], NULL, carveTiles, &job) != 0) {
+            printf("Error: Cannot start worker thread %d.\n", i);
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (int i = 0; i < threads; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    free(workers);
+
+    // Seams: 2 * t is the seam below tile t, 2 * t + 1 the seam to its right
+    int tileCount = job.tileRows * job.tileCols;
+    int *parent = (int *)malloc(tileCount * sizeof(int));
+    int *seams = (int *)malloc(2 * tileCount * sizeof(int));
+    if (!parent || !seams) {
+        printf("Error: Cannot allocate the seam lists.\n");
+        exit(EXIT_FAILURE);
+    }
+    int seamCount = 0;
+    for (int t = 0; t < tileCount; t++) {
+        parent[t] = t;
+        if (t / job.tileCols + 1 < job.tileRows) {
+            seams[seamCount++] = 2 * t;
+        }
+        if (t % job.tileCols + 1 < job.tileCols) {
+            seams[seamCount++] = 2 * t + 1;
+        }
+    }
+    for (int i = seamCount - 1; i > 0; i--) {
+        int j = rand() % (i + 1);
+        int swap = seams[i];
+        seams[i] = seams[j];
+        seams[j] = swap;
+    }
+
+    for (int i = 0; i < seamCount; i++) {
+        int t = seams[i] / 2, right = seams[i] % 2;
+        int other = right ? t + 1 : t + job.tileCols;
+        int a = findSet(parent, t), b = findSet(parent, other);
+        if (a == b) {
+            continue;
+        }
+        parent[a] = b;
 
-        if (newX > 0 && newX < rows && newY > 0 && newY < cols && maze[newX][newY] == WALL) {
-            maze[betweenX][betweenY] = PATH; // Carve through the wall
-            carvePath(maze, rows, cols, newX, newY);
+        // Open one wall at a random position along the seam
+        int firstRow = (t / job.tileCols) * TILE_CELLS, firstCol = (t % job.tileCols) * TILE_CELLS;
+        int row, col;
+        if (right) {
+            int height = (firstRow + TILE_CELLS < job.cellRows ? TILE_CELLS : job.cellRows - firstRow);
+            row = 2 * (firstRow + rand() % height) + 1;
+            col = 2 * (firstCol + TILE_CELLS);
+        } else {
+            int width = (firstCol + TILE_CELLS < job.cellCols ? TILE_CELLS : job.cellCols - firstCol);
+            row = 2 * (firstRow + TILE_CELLS);
+            col = 2 * (firstCol + rand() % width) + 1;
         }
+        maze->cells[maze_index(maze, row, col)] = PATH;
+    }
+    free(parent);
+    free(seams);
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double seconds = (end.tv_sec - begin.tv_sec) + (end.tv_nsec - begin.tv_nsec) / 1e9;
+    double cellsPerSecond = (double)maze->rows * maze->cols / seconds;
+    printf("%d thread(s): %d tiles carved and stitched in %.3f s, %.0f cells/s\n",
+           threads, tileCount, seconds, cellsPerSecond);
+    return cellsPerSecond;
+}
+
+// Generate a perfect maze with Eller's algorithm and write it one row at a time. Only the set
+// labels of the current row are kept (O(cols) memory), so the number of rows is unbounded.
+// Cells sit at odd positions like carvePath's, and 's'/'g' go where placeStartAndGoal puts them.
+void generateStreamingMaze(int rows, int cols, const char *filename) {
+    int cellRows = (rows - 1) / 2, cellCols = (cols - 1) / 2;
+    if (cellRows < 1 || cellCols < 1) {
+        printf("Error: A streaming maze needs at least 3 rows and 3 columns.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // label: set of each column carried from the row above; labels are < 2 * cellCols.
+    // parent: union-find over the columns of the current row. first: column seen first per label.
+    int *label = (int *)malloc(cellCols * sizeof(int));
+    int *parent = (int *)malloc(cellCols * sizeof(int));
+    int *first = (int *)malloc(2 * cellCols * sizeof(int));
+    int *remaining = (int *)malloc(cellCols * sizeof(int));
+    unsigned char *down = (unsigned char *)malloc(cellCols);
+    unsigned char *hasDown = (unsigned char *)malloc(cellCols);
+    if (!label || !parent || !first || !remaining || !down || !hasDown) {
+        printf("Error: Cannot allocate the row state.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int c = 0; c < cellCols; c++) {
+        label[c] = c;
+    }
+    for (int l = 0; l < 2 * cellCols; l++) {
+        first[l] = -1;
+    }
+
+    struct maze_writer writer;
+    if (maze_writer_open(&writer, filename) < 0) {
+        exit(EXIT_FAILURE);
+    }
+    maze_writer_header(&writer, rows, cols);
+
+    // Top border
+    char *line = maze_writer_reserve(&writer, cols + 1);
+    memset(line, WALL, cols);
+    line[cols] = '\n';
+
+    for (int r = 0; r < cellRows; r++) {
+        bool lastRow = (r == cellRows - 1);
+
+        // Columns that share a label were joined in an earlier row
+        for (int c = 0; c < cellCols; c++) {
+            if (first[label[c]] < 0) {
+                first[label[c]] = c;
+            }
+            parent[c] = first[label[c]];
+        }
+        for (int c = 0; c < cellCols; c++) {
+            first[label[c]] = -1;
+        }
+
+        // Cell row: join neighbours in different sets at random (always on the last row)
+        line = maze_writer_reserve(&writer, cols + 1);
+        memset(line, WALL, cols);
+        line[cols] = '\n';
+        for (int c = 0; c < cellCols; c++) {
+            line[2 * c + 1] = PATH;
+            if (c + 1 < cellCols) {
+                int a = findSet(parent, c), b = findSet(parent, c + 1);
+                if (a != b && (lastRow || rand() % 2)) {
+                    parent[a < b ? b : a] = a < b ? a : b;
+                    line[2 * c + 2] = PATH;
+                }
+            }
+        }
+        if (r == 0) {
+            line[1] = START;
+        }
+        if (lastRow) {
+            line[2 * cellCols - 1] = GOAL;
+        }
+
+        // Nothing opens below the last cell row
+        if (lastRow) {
+            break;
+        }
+
+        // Vertical row: every set keeps at least one cell going down
+        for (int c = 0; c < cellCols; c++) {
+            remaining[c] = 0;
+            hasDown[c] = 0;
+        }
+        for (int c = 0; c < cellCols; c++) {
+            remaining[findSet(parent, c)]++;
+        }
+        line = maze_writer_reserve(&writer, cols + 1);
+        memset(line, WALL, cols);
+        line[cols] = '\n';
+        for (int c = 0; c < cellCols; c++) {
+            int root = findSet(parent, c);
+            remaining[root]--;
+            down[c] = rand() % 2 || (remaining[root] == 0 && !hasDown[root]);
+            if (down[c]) {
+                hasDown[root] = 1;
+                line[2 * c + 1] = PATH;
+            }
+        }
+
+        // Cells below keep their set; the rest start fresh sets that cannot clash with a root
+        for (int c = 0; c < cellCols; c++) {
+            label[c] = down[c] ? findSet(parent, c) : cellCols + c;
+        }
+    }
+
+    // Bottom border, plus the spare wall row when the size leaves one
+    for (int r = 2 * cellRows; r < rows; r++) {
+        line = maze_writer_reserve(&writer, cols + 1);
+        memset(line, WALL, cols);
+        line[cols] = '\n';
+    }
+
+    free(label);
+    free(parent);
+    free(first);
+    free(remaining);
+    free(down);
+    free(hasDown);
+    if (maze_writer_close(&writer) < 0) {
+        exit(EXIT_FAILURE);
     }
 }
 
 // Generate a maze with additional obstacles
-void generateMazeWithObstacles(char **maze, int rows, int cols, int obstacleCount) {
+void generateMazeWithObstacles(struct maze_grid *maze, int obstacleCount) {
     for (int i = 0; i < obstacleCount; i++) {
-        int randRow = rand() % rows;
-        int randCol = rand() % cols;
+        int randRow = rand() % maze->rows;
+        int randCol = rand() % maze->cols;
+        char *cell = &maze->cells[maze_index(maze, randRow, randCol)];
 
         // Place an obstacle if it's not the start, goal, or already a wall
-        if (maze[randRow][randCol] == PATH) {
-            maze[randRow][randCol] = WALL;
+        if (*cell == PATH) {
+            *cell = WALL;
         }
     }
 }
 
+// Label the connected areas of the saved maze on every CPU and cache the label map next to it
+// (maze.txt -> maze.lbl), so solvers can tell at once whether a query has a path. Obstacles
+// often cut the goal off from the start; say so right away.
+void labelMaze(const struct maze_grid *maze, const char *filename, int startRow, int startCol, int goalRow, int goalCol) {
+    struct maze_bitmap walls;
+    maze_bitmap_from_grid(&walls, maze, WALL);
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    struct maze_labels labels;
+    struct timespec begin, end;
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    if (maze_labels_prepare(&labels, filename, &walls, cpus > 1 ? (int)cpus : 1) < 0) {
+        exit(EXIT_FAILURE);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    char path[4096];
+    maze_labels_path(filename, path, sizeof(path));
+    printf("Labelled %d connected areas in %.3f s and saved them to '%s'.\n", labels.num_components,
+           (end.tv_sec - begin.tv_sec) + (end.tv_nsec - begin.tv_nsec) / 1e9, path);
+    if (!maze_labels_connected(&labels, maze_bit_index(&walls, startRow, startCol), maze_bit_index(&walls, goalRow, goalCol))) {
+        printf("Warning: The goal cannot be reached from the start.\n");
+    }
+    maze_labels_free(&labels);
+    maze_bitmap_free(&walls);
+}
+
 // Place the start ('s') and goal ('g') in the maze
-void placeStartAndGoal(char **maze, int rows, int cols, int *startRow, int *startCol, int *goalRow, int *goalCol) {
+void placeStartAndGoal(struct maze_grid *maze, int *startRow, int *startCol, int *goalRow, int *goalCol) {
     // Place start at the top-left corner of the maze
     *startRow = 1;
     *startCol = 1;
-    maze[*startRow][*startCol] = START;
+    maze->cells[maze_index(maze, *startRow, *startCol)] = START;
 
     // Place goal at the bottom-right corner of the maze
-    *goalRow = rows - 2;
-    *goalCol = cols - 2;
-    maze[*goalRow][*goalCol] = GOAL;
+    *goalRow = maze->rows - 2;
+    *goalCol = maze->cols - 2;
+    maze->cells[maze_index(maze, *goalRow, *goalCol)] = GOAL;
 }
 
-// Write the maze to a file
-void writeMazeToFile(char **maze, int rows, int cols, const char *filename) {
-    FILE *file = fopen(filename, "w");
-    if (!file) {
-        printf("Error: Cannot write to file %s.\n", filename);
+// Write the maze to a file, a whole row at a time
+void writeMazeToFile(const struct maze_grid *maze, const char *filename) {
+    if (maze_write_grid(maze, filename, 1) < 0) {
         exit(EXIT_FAILURE);
     }
-
-    fprintf(file, "%d,%d\n", rows, cols);
-    for (int i = 0; i < rows; i++) {
-        for (int j = 0; j < cols; j++) {
-            fprintf(file, "%c", maze[i][j]);
-        }
-        fprintf(file, "\n");
-    }
-
-    fclose(file);
 }
@@ -0,0 +1,589 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "maze_io.h"
+
+#if defined(MAZE_SIMD_AVX2) || defined(MAZE_SIMD_SSE2)
+#include <immintrin.h>
+#endif
+
+#ifdef _WIN32
+#include <errno.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+// Map the whole file read-only (or read it into memory where mmap is not available)
+static int map_file(struct maze_file* file, const char* path) {
+#ifdef _WIN32
+    FILE* fp = fopen(path, "rb");
+    if (!fp) {
+        printf("Error: Cannot open file %s.\n", path);
+        return -1;
+    }
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    file->data = (char*)malloc(size > 0 ? size : 1);
+    if (!file->data || fread(file->data, 1, size, fp) != (size_t)size) {
+        printf("Error: Cannot read file %s.\n", path);
+        fclose(fp);
+        free(file->data);
+        file->data = NULL;
+        return -1;
+    }
+    fclose(fp);
+    file->size = size;
+    return 0;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        printf("Error: Cannot open file %s.\n", path);
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size == 0) {
+        printf("Error: Cannot read file %s.\n", path);
+        close(fd);
+        return -1;
+    }
+    void* data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        printf("Error: Cannot map file %s.\n", path);
+        return -1;
+    }
+    madvise(data, st.st_size, MADV_SEQUENTIAL);
+    file->data = (char*)data;
+    file->size = st.st_size;
+    return 0;
+#endif
+}
+
+static void unmap_file(struct maze_file* file) {
+    if (!file->data) {
+        return;
+    }
+#ifdef _WIN32
+    free(file->data);
+#else
+    munmap(file->data, file->size);
+#endif
+    file->data = NULL;
+}
+
+// Parse a positive decimal integer at *pos, advancing past it
+static int parse_dimension(const char* data, size_t size, size_t* pos, int* value) {
+    long long result = 0;
+    size_t start = *pos;
+    while (*pos < size && data[*pos] >= '0' && data[*pos] <= '9') {
+        result = result * 10 + (data[*pos] - '0');
+        if (result > INT_MAX) {
+            return -1;
+        }
+        (*pos)++;
+    }
+    if (*pos == start || result == 0) {
+        return -1;
+    }
+    *value = (int)result;
+    return 0;
+}
+
+// Look at the cells the movemask flagged: a newline ends the row early (returns -1), and the
+// first 's' and 'g' are recorded
+static int note_row_hits(const char* line, int base, uint32_t mask, int* s_col, int* g_col) {
+    while (mask) {
+        int col = base + __builtin_ctz(mask);
+        if (line[col] == '\n') {
+            return -1;
+        }
+        if (line[col] == 's' && *s_col < 0) {
+            *s_col = col;
+        } else if (line[col] == 'g' && *g_col < 0) {
+            *g_col = col;
+        }
+        mask &= mask - 1;
+    }
+    return 0;
+}
+
+// One pass over a text row in place of a memchr each for '\n', 's' and 'g'. Blocks of 32 (AVX2)
+// or 16 (SSE2) cells are compared against all three at once; only blocks that hit anything are
+// looked at cell by cell, which in a maze is the one or two holding s and g.
+static int scan_row(const char* line, int cols, int* s_col, int* g_col) {
+    int col = 0;
+#if defined(MAZE_SIMD_AVX2)
+    const __m256i newline = _mm256_set1_epi8('\n'), start = _mm256_set1_epi8('s'), goal = _mm256_set1_epi8('g');
+    for (; col + 32 <= cols; col += 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i*)(line + col));
+        __m256i hits = _mm256_or_si256(_mm256_cmpeq_epi8(block, newline),
+                                       _mm256_or_si256(_mm256_cmpeq_epi8(block, start), _mm256_cmpeq_epi8(block, goal)));
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(hits);
+        if (mask && note_row_hits(line, col, mask, s_col, g_col) < 0) {
+            return -1;
+        }
+    }
+#elif defined(MAZE_SIMD_SSE2)
+    const __m128i newline = _mm_set1_epi8('\n'), start = _mm_set1_epi8('s'), goal = _mm_set1_epi8('g');
+    for (; col + 16 <= cols; col += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*)(line + col));
+        __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(block, newline),
+                                    _mm_or_si128(_mm_cmpeq_epi8(block, start), _mm_cmpeq_epi8(block, goal)));
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(hits);
+        if (mask && note_row_hits(line, col, mask, s_col, g_col) < 0) {
+            return -1;
+        }
+    }
+#endif
+    for (; col < cols; col++) {
+        char c = line[col];
+        if (c == '\n' || c == 's' || c == 'g') {
+            if (note_row_hits(line, col, 1, s_col, g_col) < 0) {
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+uint64_t mzb_checksum(const void* data, size_t size) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Validate the .mzb header and checksum, and expose the payload rows
+// 1 if (row, col) is absent (-1, -1) or a cell of a rows x cols maze
+static int valid_position(int32_t row, int32_t col, int rows, int cols) {
+    if (row == -1 && col == -1) {
+        return 1;
+    }
+    return row >= 0 && row < rows && col >= 0 && col < cols;
+}
+
+static int open_mzb(struct maze_file* file, const char* path) {
+    struct mzb_header header;
+    if (file->size < MZB_PAYLOAD_OFFSET) {
+        printf("Error: %s is truncated: no room for the .mzb header.\n", path);
+        return -1;
+    }
+    memcpy(&header, file->data, sizeof(header));
+    if (header.version != MZB_VERSION) {
+        printf("Error: %s has unsupported .mzb version %u.\n", path, header.version);
+        return -1;
+    }
+    if (header.rows == 0 || header.cols == 0 || header.rows > INT_MAX || header.cols > INT_MAX ||
+        (long long)header.rows * maze_stride_for((int)header.cols) > INT_MAX) {
+        printf("Error: %s has invalid dimensions %u x %u.\n", path, header.rows, header.cols);
+        return -1;
+    }
+    file->rows = (int)header.rows;
+    file->cols = (int)header.cols;
+    if (!valid_position(header.start_row, header.start_col, file->rows, file->cols) ||
+        !valid_position(header.goal_row, header.goal_col, file->rows, file->cols)) {
+        printf("Error: %s has its start or goal outside the maze.\n", path);
+        return -1;
+    }
+
+    size_t expected_row_bytes = header.encoding == MZB_ENCODING_BYTE ? (size_t)file->cols
+                              : header.encoding == MZB_ENCODING_BITS ? (size_t)maze_stride_for(file->cols) / 8
+                              : 0;
+    if (expected_row_bytes == 0 || header.row_bytes != expected_row_bytes ||
+        header.payload_offset != MZB_PAYLOAD_OFFSET ||
+        header.payload_size != (uint64_t)header.row_bytes * header.rows) {
+        printf("Error: %s has an inconsistent .mzb header.\n", path);
+        return -1;
+    }
+    if (file->size < header.payload_offset + header.payload_size) {
+        printf("Error: %s is truncated: expected %llu payload bytes.\n", path,
+               (unsigned long long)header.payload_size);
+        return -1;
+    }
+    const char* payload = file->data + header.payload_offset;
+    if (mzb_checksum(payload, header.payload_size) != header.checksum) {
+        printf("Error: %s failed its checksum.\n", path);
+        return -1;
+    }
+
+    file->encoding = (enum mzb_encoding)header.encoding;
+    file->start_row = header.start_row;
+    file->start_col = header.start_col;
+    file->goal_row = header.goal_row;
+    file->goal_col = header.goal_col;
+    if (file->encoding == MZB_ENCODING_BYTE) {
+        file->body = payload;
+        file->row_pitch = file->cols;
+        return 0;
+    }
+
+    // Bit-encoded: keep the words for maze_file_to_bitmap and expand text rows for everything else
+    file->bits = (const uint64_t*)payload;
+    file->decoded = (char*)malloc((size_t)file->rows * file->cols);
+    if (!file->decoded) {
+        printf("Error: Cannot allocate a %d x %d maze.\n", file->rows, file->cols);
+        return -1;
+    }
+    struct maze_bitmap view = { file->rows, file->cols, maze_stride_for(file->cols),
+                                maze_stride_for(file->cols) / 64, (uint64_t*)file->bits };
+    for (int row = 0; row < file->rows; row++) {
+        maze_render_row(file->decoded + (size_t)row * file->cols, &view, NULL, row);
+    }
+    if (file->start_row >= 0) {
+        file->decoded[(size_t)file->start_row * file->cols + file->start_col] = 's';
+    }
+    if (file->goal_row >= 0) {
+        file->decoded[(size_t)file->goal_row * file->cols + file->goal_col] = 'g';
+    }
+    file->body = file->decoded;
+    file->row_pitch = file->cols;
+    return 0;
+}
+
+int maze_file_open(struct maze_file* file, const char* path) {
+    memset(file, 0, sizeof(*file));
+    file->start_row = file->start_col = -1;
+    file->goal_row = file->goal_col = -1;
+    if (map_file(file, path) < 0) {
+        return -1;
+    }
+
+    const char* data = file->data;
+    size_t size = file->size, pos = 0;
+
+    if (size >= 4 && memcmp(data, MZB_MAGIC, 4) == 0) {
+        if (open_mzb(file, path) < 0) {
+            maze_file_close(file);
+            return -1;
+        }
+        return 0;
+    }
+
+    // Header: rows,cols
+    if (parse_dimension(data, size, &pos, &file->rows) < 0 || pos >= size || data[pos++] != ',' ||
+        parse_dimension(data, size, &pos, &file->cols) < 0) {
+        printf("Error: %s does not start with a valid \"rows,cols\" header.\n", path);
+        maze_file_close(file);
+        return -1;
+    }
+    if ((long long)file->rows * maze_stride_for(file->cols) > INT_MAX) {
+        printf("Error: %s is too large (%d x %d).\n", path, file->rows, file->cols);
+        maze_file_close(file);
+        return -1;
+    }
+    if (pos < size && data[pos] == '\r') {
+        pos++;
+    }
+    if (pos >= size || data[pos++] != '\n') {
+        printf("Error: %s has trailing characters after the header.\n", path);
+        maze_file_close(file);
+        return -1;
+    }
+    file->body = data + pos;
+
+    // The first line decides whether rows end in "\n" or "\r\n"
+    size_t remaining = size - pos, cols = file->cols;
+    size_t eol = (remaining > cols && file->body[cols] == '\r') ? 2 : 1;
+    file->row_pitch = cols + eol;
+
+    // Every row must be exactly cols cells followed by the same line ending (optional after the last row)
+    if (remaining < (size_t)(file->rows - 1) * file->row_pitch + cols) {
+        printf("Error: %s is truncated: expected %d rows of %d cells.\n", path, file->rows, file->cols);
+        maze_file_close(file);
+        return -1;
+    }
+    for (int row = 0; row < file->rows; row++) {
+        const char* line = maze_file_row(file, row);
+        const char* end = line + cols;
+        int ok;
+        if (row == file->rows - 1) {
+            ok = (end == data + size || *end == '\r' || *end == '\n');
+        } else {
+            ok = (eol == 2) ? (end[0] == '\r' && end[1] == '\n') : (end[0] == '\n');
+        }
+        int s_col = -1, g_col = -1;
+        if (!ok || scan_row(line, file->cols, &s_col, &g_col) < 0) {
+            printf("Error: %s row %d does not have exactly %d cells.\n", path, row, file->cols);
+            maze_file_close(file);
+            return -1;
+        }
+        if (s_col >= 0 && file->start_row < 0) {
+            file->start_row = row;
+            file->start_col = s_col;
+        }
+        if (g_col >= 0 && file->goal_row < 0) {
+            file->goal_row = row;
+            file->goal_col = g_col;
+        }
+    }
+    return 0;
+}
+
+void maze_file_close(struct maze_file* file) {
+    unmap_file(file);
+    free(file->decoded);
+    file->decoded = NULL;
+    file->bits = NULL;
+    file->body = NULL;
+}
+
+int maze_file_checksum(const char* path, uint64_t* checksum, uint64_t* size) {
+    struct maze_file file;
+    memset(&file, 0, sizeof(file));
+    if (map_file(&file, path) < 0) {
+        return -1;
+    }
+    *checksum = mzb_checksum(file.data, file.size);
+    *size = file.size;
+    unmap_file(&file);
+    return 0;
+}
+
+void maze_sidecar_path(const char* maze_path, const char* suffix, char* out, size_t size) {
+    snprintf(out, size, "%s%s", maze_path, suffix);
+}
+
+void maze_file_to_grid(const struct maze_file* file, struct maze_grid* grid) {
+    maze_grid_alloc(grid, file->rows, file->cols);
+    for (int row = 0; row < file->rows; row++) {
+        memcpy(maze_row(grid, row), maze_file_row(file, row), file->cols);
+    }
+}
+
+void maze_file_to_bitmap(const struct maze_file* file, struct maze_bitmap* bits, char value) {
+    maze_bitmap_alloc(bits, file->rows, file->cols);
+    if (file->bits && value == 'x') {
+        // Same row layout as the payload: one copy, no per-cell work
+        memcpy(bits->words, file->bits, (size_t)file->rows * bits->words_per_row * sizeof(uint64_t));
+        maze_bitmap_seal(bits);
+        return;
+    }
+    for (int row = 0; row < file->rows; row++) {
+        maze_bits_pack_row(bits->words + (size_t)row * bits->words_per_row, maze_file_row(file, row), file->cols, value);
+    }
+    maze_bitmap_seal(bits);
+}
+
+int maze_writer_open(struct maze_writer* writer, const char* path) {
+    memset(writer, 0, sizeof(*writer));
+    size_t length = strlen(path);
+    writer->capacity = MAZE_WRITER_BUFFER;
+    writer->buffer = (char*)malloc(writer->capacity);
+    writer->path = (char*)malloc(2 * length + 6);
+    if (!writer->buffer || !writer->path) {
+        printf("Error: Cannot allocate the output buffer.\n");
+        free(writer->buffer);
+        free(writer->path);
+        writer->buffer = NULL;
+        writer->path = NULL;
+        return -1;
+    }
+    writer->temp_path = writer->path + length + 1;
+    memcpy(writer->path, path, length + 1);
+    memcpy(writer->temp_path, path, length);
+    memcpy(writer->temp_path + length, ".tmp", 5);
+    writer->file = fopen(writer->temp_path, "wb");
+    if (!writer->file) {
+        printf("Error: Cannot write to file %s.\n", path);
+        free(writer->buffer);
+        free(writer->path);
+        writer->buffer = NULL;
+        writer->path = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+static int flush_writer(struct maze_writer* writer) {
+    if (writer->used > 0 && fwrite(writer->buffer, 1, writer->used, writer->file) != writer->used) {
+        writer->used = 0;
+        return -1;
+    }
+    writer->used = 0;
+    return 0;
+}
+
+char* maze_writer_reserve(struct maze_writer* writer, size_t length) {
+    if (writer->capacity - writer->used < length) {
+        if (flush_writer(writer) < 0) {
+            printf("Error: Write failed.\n");
+            exit(EXIT_FAILURE);
+        }
+        if (length > writer->capacity) {
+            char* grown = (char*)realloc(writer->buffer, length);
+            if (!grown) {
+                printf("Error: Cannot grow the output buffer.\n");
+                exit(EXIT_FAILURE);
+            }
+            writer->buffer = grown;
+            writer->capacity = length;
+        }
+    }
+    char* space = writer->buffer + writer->used;
+    writer->used += length;
+    writer->bytes += length;
+    return space;
+}
+
+void maze_writer_write(struct maze_writer* writer, const char* data, size_t length) {
+    memcpy(maze_writer_reserve(writer, length), data, length);
+}
+
+void maze_writer_header(struct maze_writer* writer, int rows, int cols) {
+    char header[32];
+    int length = snprintf(header, sizeof(header), "%d,%d\n", rows, cols);
+    maze_writer_write(writer, header, length);
+}
+
+int maze_writer_close(struct maze_writer* writer) {
+    int result = flush_writer(writer);
+    if (fclose(writer->file) != 0) {
+        result = -1;
+    }
+    if (result < 0) {
+        printf("Error: Write failed.\n");
+        remove(writer->temp_path);
+    } else {
+#ifdef _WIN32
+        // rename does not replace an existing file here
+        remove(writer->path);
+#endif
+        if (rename(writer->temp_path, writer->path) != 0) {
+            printf("Error: Cannot replace file %s.\n", writer->path);
+            remove(writer->temp_path);
+            result = -1;
+        }
+    }
+    free(writer->buffer);
+    free(writer->path);
+    writer->file = NULL;
+    writer->buffer = NULL;
+    writer->path = NULL;
+    writer->temp_path = NULL;
+    return result;
+}
+
+int maze_write_grid(const struct maze_grid* grid, const char* path, int with_header) {
+    struct maze_writer writer;
+    if (maze_writer_open(&writer, path) < 0) {
+        return -1;
+    }
+    if (with_header) {
+        maze_writer_header(&writer, grid->rows, grid->cols);
+    }
+    for (int row = 0; row < grid->rows; row++) {
+        char* line = maze_writer_reserve(&writer, grid->cols + 1);
+        memcpy(line, maze_row(grid, row), grid->cols);
+        line[grid->cols] = '\n';
+    }
+    return maze_writer_close(&writer);
+}
+
+int maze_write_marked(const struct maze_file* file, const struct maze_bitmap* marks, const char* path) {
+    struct maze_writer writer;
+    if (maze_writer_open(&writer, path) < 0) {
+        return -1;
+    }
+
+    for (int i = 0; i < file->rows; i++) {
+        char* line = maze_writer_reserve(&writer, file->cols + 1);
+        memcpy(line, maze_file_row(file, i), file->cols);
+        line[file->cols] = '\n';
+
+        const uint64_t* words = marks->words + (size_t)i * marks->words_per_row;
+        for (int w = 0; w < marks->words_per_row; w++) {
+            uint64_t word = words[w];
+            while (word) {
+                int j = w * 64 + __builtin_ctzll(word);
+                if (line[j] != 's') {
+                    line[j] = '.';
+                }
+                word &= word - 1;
+            }
+        }
+    }
+
+    return maze_writer_close(&writer);
+}
+
+// Set out[col] = c for every set bit of the bitmap in this row
+static void render_bits(char* out, const struct maze_bitmap* bits, int row, char c) {
+    const uint64_t* words = bits->words + (size_t)row * bits->words_per_row;
+    int full_words = bits->cols / 64;
+    for (int w = 0; w <= full_words && w < bits->words_per_row; w++) {
+        uint64_t word = words[w];
+        if (w == full_words) {
+            word &= ((uint64_t)1 << (bits->cols & 63)) - 1;  // Drop the padding columns
+        }
+        while (word) {
+            out[w * 64 + __builtin_ctzll(word)] = c;
+            word &= word - 1;
+        }
+    }
+}
+
+void maze_render_row(char* out, const struct maze_bitmap* walls, const struct maze_bitmap* path, int row) {
+    memset(out, ' ', walls->cols);
+    render_bits(out, walls, row, 'x');
+    if (path) {
+        render_bits(out, path, row, '.');
+    }
+}
+
+int maze_write_mzb(const struct maze_grid* grid, const char* path, enum mzb_encoding encoding,
+                   int start_row, int start_col, int goal_row, int goal_col) {
+    struct mzb_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MZB_MAGIC, 4);
+    header.version = MZB_VERSION;
+    header.rows = grid->rows;
+    header.cols = grid->cols;
+    header.start_row = start_row;
+    header.start_col = start_col;
+    header.goal_row = goal_row;
+    header.goal_col = goal_col;
+    header.encoding = encoding;
+    header.row_bytes = encoding == MZB_ENCODING_BITS ? grid->stride / 8 : grid->cols;
+    header.payload_offset = MZB_PAYLOAD_OFFSET;
+    header.payload_size = (uint64_t)header.row_bytes * grid->rows;
+
+    // Build the payload first so the checksum can go in the header
+    char* payload = (char*)malloc(header.payload_size);
+    struct maze_bitmap walls = { 0 };
+    if (!payload) {
+        printf("Error: Cannot allocate the .mzb payload.\n");
+        return -1;
+    }
+    if (encoding == MZB_ENCODING_BITS) {
+        maze_bitmap_from_grid(&walls, grid, 'x');
+        memcpy(payload, walls.words, header.payload_size);
+        maze_bitmap_free(&walls);
+    } else {
+        for (int row = 0; row < grid->rows; row++) {
+            memcpy(payload + (size_t)row * grid->cols, maze_row(grid, row), grid->cols);
+        }
+    }
+    header.checksum = mzb_checksum(payload, header.payload_size);
+
+    struct maze_writer writer;
+    if (maze_writer_open(&writer, path) < 0) {
+        free(payload);
+        return -1;
+    }
+    char* head = maze_writer_reserve(&writer, MZB_PAYLOAD_OFFSET);
+    memset(head, 0, MZB_PAYLOAD_OFFSET);
+    memcpy(head, &header, sizeof(header));
+    for (uint64_t done = 0; done < header.payload_size; done += MAZE_WRITER_BUFFER) {
+        uint64_t chunk = header.payload_size - done < MAZE_WRITER_BUFFER ? header.payload_size - done : MAZE_WRITER_BUFFER;
+        maze_writer_write(&writer, payload + done, chunk);
+    }
+    free(payload);
+    return maze_writer_close(&writer);
+}
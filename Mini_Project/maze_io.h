@@ -0,0 +1,122 @@
+#ifndef MAZE_IO_H
+#define MAZE_IO_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "maze_core.h"
+#include "maze_bits.h"
+
+// Binary maze format (.mzb): a fixed little-endian header padded to MZB_PAYLOAD_OFFSET, then
+// the payload, one row after another. The payload starts on a page boundary so a mapped
+// file can be used in place, and its FNV-1a checksum is stored in the header.
+#define MZB_MAGIC "MZB1"
+#define MZB_VERSION 1
+#define MZB_PAYLOAD_OFFSET 4096
+
+enum mzb_encoding {
+    MZB_ENCODING_TEXT = 0,   // Not a binary file: text rows
+    MZB_ENCODING_BYTE = 1,   // One text character per cell, cols bytes per row
+    MZB_ENCODING_BITS = 2    // Wall bitmap rows laid out like struct maze_bitmap (stride / 8 bytes per row)
+};
+
+struct mzb_header {
+    char magic[4];
+    uint32_t version;
+    uint32_t rows;
+    uint32_t cols;
+    int32_t start_row, start_col;
+    int32_t goal_row, goal_col;
+    uint32_t encoding;
+    uint32_t row_bytes;
+    uint64_t payload_offset;
+    uint64_t payload_size;
+    uint64_t checksum;
+};
+
+uint64_t mzb_checksum(const void* data, size_t size);
+
+// A maze file mapped into memory: either text ("rows,cols" header, then rows lines of cols
+// cells) or .mzb. Text and byte-encoded rows are exposed zero-copy: maze_file_row() points
+// straight into the mapping. Bit-encoded files are expanded to text rows once on open.
+struct maze_file {
+    int rows;
+    int cols;
+    int start_row, start_col;   // Position of 's' (-1 if absent)
+    int goal_row, goal_col;     // Position of 'g' (-1 if absent)
+    const char* body;           // First cell of row 0
+    size_t row_pitch;           // Bytes from one row to the next (cols + 1 for "\n", cols + 2 for "\r\n")
+    char* data;                 // Whole file
+    size_t size;
+    enum mzb_encoding encoding;
+    const uint64_t* bits;       // Bit-encoded payload (MZB_ENCODING_BITS only)
+    char* decoded;              // Text rows expanded from bits (owned)
+};
+
+// Map and validate a maze file of either format. Prints a message and returns -1 on any error.
+int maze_file_open(struct maze_file* file, const char* path);
+void maze_file_close(struct maze_file* file);
+
+// mzb_checksum over every byte of a file, and its size: what the caches kept next to a maze
+// record to tell whether they are stale. Prints a message and returns -1 if the file cannot be read.
+int maze_file_checksum(const char* path, uint64_t* checksum, uint64_t* size);
+
+// Name of a cache file kept next to a maze: the whole maze path, extension included, plus the
+// suffix, so maze.txt and maze.mzb never share one (maze.txt -> maze.txt.jgr)
+void maze_sidecar_path(const char* maze_path, const char* suffix, char* out, size_t size);
+
+static inline const char* maze_file_row(const struct maze_file* file, int row) {
+    return file->body + (size_t)row * file->row_pitch;
+}
+
+// Copy the cells into a freshly allocated grid, one row at a time
+void maze_file_to_grid(const struct maze_file* file, struct maze_grid* grid);
+
+// Build a sealed bitmap with a bit set for every cell equal to value
+void maze_file_to_bitmap(const struct maze_file* file, struct maze_bitmap* bits, char value);
+
+// Write a grid as .mzb with the given encoding (MZB_ENCODING_BYTE or MZB_ENCODING_BITS)
+int maze_write_mzb(const struct maze_grid* grid, const char* path, enum mzb_encoding encoding,
+                   int start_row, int start_col, int goal_row, int goal_col);
+
+// Buffered output: whole rows are assembled in one large reusable buffer and written with
+// fwrite, instead of one fprintf call per cell
+#define MAZE_WRITER_BUFFER (1 << 20)
+
+struct maze_writer {
+    FILE* file;
+    char* buffer;
+    size_t used;
+    size_t capacity;
+    unsigned long long bytes;   // Total bytes handed to the writer
+    char* path;                 // Destination, followed by the temporary name actually written
+    char* temp_path;
+};
+
+// Open path for writing. The data goes to path.tmp, which maze_writer_close renames over path,
+// so an interrupted or failed write never leaves a truncated file (or cache) under the real name.
+// Prints a message and returns -1 on error.
+int maze_writer_open(struct maze_writer* writer, const char* path);
+
+// Return space for length bytes in the buffer; the caller fills it in place
+char* maze_writer_reserve(struct maze_writer* writer, size_t length);
+
+void maze_writer_write(struct maze_writer* writer, const char* data, size_t length);
+void maze_writer_header(struct maze_writer* writer, int rows, int cols);
+
+// Flush, close and move the file into place. Returns -1 (and removes the temporary file) if any
+// write failed.
+int maze_writer_close(struct maze_writer* writer);
+
+// Write every row of the grid followed by '\n', optionally after the "rows,cols" header
+int maze_write_grid(const struct maze_grid* grid, const char* path, int with_header);
+
+// Write the maze rows of file with a '.' on every set bit of marks except the start cell
+// (no header). Each row is copied from the file and only the marked cells are patched.
+int maze_write_marked(const struct maze_file* file, const struct maze_bitmap* marks, const char* path);
+
+// Fill one output row from bitmaps: '.' for path cells, 'x' for walls and ' ' elsewhere
+// (path may be NULL)
+void maze_render_row(char* out, const struct maze_bitmap* walls, const struct maze_bitmap* path, int row);
+
+#endif
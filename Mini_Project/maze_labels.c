@@ -0,0 +1,303 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <pthread.h>
+#include "maze_labels.h"
+#include "maze_io.h"
+
+// State shared by the labelling threads. Thread t owns rows [row_begin[t], row_begin[t + 1]).
+struct label_shared {
+    const struct maze_bitmap* walls;
+    int32_t* parent;            // Union-find forest over the open cells; roots are their own parent
+    int32_t* label;
+    int threads;
+    int* row_begin;
+    int* roots;                 // Roots (components) found in each strip
+    pthread_barrier_t barrier;
+};
+
+struct label_worker {
+    struct label_shared* shared;
+    int id;
+};
+
+// Root of cell's tree, halving the path on the way
+static int32_t find_root(int32_t* parent, int32_t cell) {
+    while (parent[cell] != cell) {
+        parent[cell] = parent[parent[cell]];
+        cell = parent[cell];
+    }
+    return cell;
+}
+
+// Join the sets of a and b under the smaller root, so every root is the first cell of its set
+static void union_cells(int32_t* parent, int32_t a, int32_t b) {
+    a = find_root(parent, a);
+    b = find_root(parent, b);
+    if (a < b) {
+        parent[b] = a;
+    } else if (b < a) {
+        parent[a] = b;
+    }
+}
+
+// Link row to the row above wherever both are open: once per stretch, since each stretch lies
+// inside one run of either row and the runs are already linked
+static void link_rows(const struct maze_bitmap* walls, int32_t* parent, int row) {
+    const uint64_t* above = walls->words + (size_t)(row - 1) * walls->words_per_row;
+    const uint64_t* below = above + walls->words_per_row;
+    uint64_t carry = 0;
+    for (int w = 0; w < walls->words_per_row; w++) {
+        uint64_t both = ~(above[w] | below[w]);
+        uint64_t starts = both & ~((both << 1) | carry);
+        carry = both >> 63;
+        while (starts) {
+            int32_t cell = row * walls->stride + w * 64 + __builtin_ctzll(starts);
+            union_cells(parent, cell, cell - walls->stride);
+            starts &= starts - 1;
+        }
+    }
+}
+
+static void* label_strip(void* arg) {
+    struct label_worker* worker = (struct label_worker*)arg;
+    struct label_shared* shared = worker->shared;
+    const struct maze_bitmap* walls = shared->walls;
+    int32_t* parent = shared->parent;
+    int32_t* label = shared->label;
+    int id = worker->id, stride = walls->stride;
+    int begin = shared->row_begin[id], end = shared->row_begin[id + 1];
+
+    // Runs along each row point at their first cell; rows inside the strip are linked to the row
+    // above. Every cell touched belongs to the strip, so the threads never share a tree yet.
+    for (int row = begin; row < end; row++) {
+        const uint64_t* words = walls->words + (size_t)row * walls->words_per_row;
+        int32_t run = -1;
+        for (int col = 0; col < walls->cols; col++) {
+            int32_t cell = row * stride + col;
+            if ((words[col >> 6] >> (col & 63)) & 1) {
+                run = -1;
+                continue;
+            }
+            run = run < 0 ? cell : run;
+            parent[cell] = run;
+        }
+        if (row > begin) {
+            link_rows(walls, parent, row);
+        }
+    }
+    pthread_barrier_wait(&shared->barrier);
+
+    // One thread joins the strips across their boundary rows
+    if (id == 0) {
+        for (int t = 1; t < shared->threads; t++) {
+            if (shared->row_begin[t] < shared->row_begin[t + 1]) {
+                link_rows(walls, parent, shared->row_begin[t]);
+            }
+        }
+    }
+    pthread_barrier_wait(&shared->barrier);
+
+    // The forest no longer changes. A parent always comes before its child, so in row-major
+    // order a cell whose parent is in the strip copies the parent's finished label; only roots
+    // the join put under a root of an earlier strip walk the forest, which nothing writes now.
+    int roots = 0;
+    for (int32_t cell = begin * stride; cell < end * stride; cell++) {
+        if (maze_bit_test(walls, cell)) {
+            label[cell] = -1;
+            continue;
+        }
+        int32_t up = parent[cell];
+        if (up == cell) {
+            label[cell] = cell;
+            roots++;
+        } else if (up >= begin * stride) {
+            label[cell] = label[up];
+        } else {
+            while (parent[up] != up) {
+                up = parent[up];
+            }
+            label[cell] = up;
+        }
+    }
+    shared->roots[id] = roots;
+    return NULL;
+}
+
+static void alloc_labels(struct maze_labels* labels) {
+    labels->label = (int32_t*)malloc((size_t)labels->rows * labels->stride * sizeof(int32_t));
+    if (!labels->label) {
+        printf("Error: Cannot allocate a %d x %d label map.\n", labels->rows, labels->cols);
+        exit(EXIT_FAILURE);
+    }
+}
+
+void maze_labels_build(struct maze_labels* labels, const struct maze_bitmap* walls, int threads) {
+    memset(labels, 0, sizeof(*labels));
+    labels->rows = walls->rows;
+    labels->cols = walls->cols;
+    labels->stride = walls->stride;
+    alloc_labels(labels);
+    if (threads < 1) {
+        threads = 1;
+    }
+    if (threads > walls->rows) {
+        threads = walls->rows;
+    }
+
+    struct label_shared shared;
+    shared.walls = walls;
+    shared.parent = (int32_t*)malloc((size_t)walls->rows * walls->stride * sizeof(int32_t));
+    shared.label = labels->label;
+    shared.threads = threads;
+    shared.row_begin = (int*)malloc((threads + 1) * sizeof(int));
+    shared.roots = (int*)malloc(threads * sizeof(int));
+    struct label_worker* workers = (struct label_worker*)malloc(threads * sizeof(struct label_worker));
+    pthread_t* ids = (pthread_t*)malloc(threads * sizeof(pthread_t));
+    if (!shared.parent || !shared.row_begin || !shared.roots || !workers || !ids) {
+        printf("Error: Cannot allocate labelling state.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int t = 0; t <= threads; t++) {
+        shared.row_begin[t] = (int)((long long)walls->rows * t / threads);
+    }
+    pthread_barrier_init(&shared.barrier, NULL, threads);
+
+    // The calling thread is worker 0
+    for (int t = 0; t < threads; t++) {
+        workers[t].shared = &shared;
+        workers[t].id = t;
+    }
+    for (int t = 1; t < threads; t++) {
+        if (pthread_create(&ids[t], NULL, label_strip, &workers[t]) != 0) {
+            printf("Error: Cannot start labelling thread %d.\n", t);
+            exit(EXIT_FAILURE);
+        }
+    }
+    label_strip(&workers[0]);
+    for (int t = 1; t < threads; t++) {
+        pthread_join(ids[t], NULL);
+    }
+
+    pthread_barrier_destroy(&shared.barrier);
+    for (int t = 0; t < threads; t++) {
+        labels->num_components += shared.roots[t];
+    }
+    free(shared.parent);
+    free(shared.row_begin);
+    free(shared.roots);
+    free(workers);
+    free(ids);
+}
+
+void maze_labels_free(struct maze_labels* labels) {
+    free(labels->label);
+    memset(labels, 0, sizeof(*labels));
+}
+
+void maze_labels_path(const char* maze_path, char* out, size_t size) {
+    maze_sidecar_path(maze_path, ".lbl", out, size);
+}
+
+// On-disk header; the label of every cell follows
+struct lbl_header {
+    char magic[4];
+    uint32_t version;
+    int32_t rows, cols, stride;
+    int32_t num_components;
+    uint64_t source_checksum;
+    uint64_t source_size;
+};
+
+int maze_labels_save(const struct maze_labels* labels, const char* path) {
+    struct lbl_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, LBL_MAGIC, 4);
+    header.version = LBL_VERSION;
+    header.rows = labels->rows;
+    header.cols = labels->cols;
+    header.stride = labels->stride;
+    header.num_components = labels->num_components;
+    header.source_checksum = labels->source_checksum;
+    header.source_size = labels->source_size;
+
+    struct maze_writer writer;
+    if (maze_writer_open(&writer, path) < 0) {
+        return -1;
+    }
+    maze_writer_write(&writer, (const char*)&header, sizeof(header));
+    maze_writer_write(&writer, (const char*)labels->label, (size_t)labels->rows * labels->stride * sizeof(int32_t));
+    return maze_writer_close(&writer);
+}
+
+int maze_labels_load(struct maze_labels* labels, const char* path, uint64_t source_checksum, uint64_t source_size) {
+    memset(labels, 0, sizeof(*labels));
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return -1;
+    }
+
+    struct lbl_header header;
+    if (fread(&header, sizeof(header), 1, file) != 1 || memcmp(header.magic, LBL_MAGIC, 4) != 0 ||
+        header.version != LBL_VERSION) {
+        printf("Error: %s is not a label file.\n", path);
+        fclose(file);
+        return -1;
+    }
+    if (header.source_checksum != source_checksum || header.source_size != source_size) {
+        printf("Note: %s was built from a different maze; rebuilding.\n", path);
+        fclose(file);
+        return -1;
+    }
+    if (header.rows < 1 || header.cols < 1 || header.stride != maze_stride_for(header.cols) ||
+        (long long)header.rows * header.stride > INT_MAX || header.num_components < 0) {
+        printf("Error: %s has an invalid header.\n", path);
+        fclose(file);
+        return -1;
+    }
+
+    labels->rows = header.rows;
+    labels->cols = header.cols;
+    labels->stride = header.stride;
+    labels->num_components = header.num_components;
+    labels->source_checksum = header.source_checksum;
+    labels->source_size = header.source_size;
+    alloc_labels(labels);
+    size_t cells = (size_t)labels->rows * labels->stride;
+    int ok = fread(labels->label, sizeof(int32_t), cells, file) == cells;
+    fclose(file);
+
+    // A label is the first cell of its component, so it labels itself
+    for (size_t i = 0; ok && i < cells; i++) {
+        int32_t root = labels->label[i];
+        ok = root >= -1 && (size_t)(root + 1) <= cells && (root < 0 || labels->label[root] == root);
+    }
+    if (!ok) {
+        printf("Error: %s is truncated or corrupt.\n", path);
+        maze_labels_free(labels);
+        return -1;
+    }
+    return 0;
+}
+
+int maze_labels_prepare(struct maze_labels* labels, const char* maze_path, const struct maze_bitmap* walls, int threads) {
+    uint64_t checksum, size;
+    if (maze_file_checksum(maze_path, &checksum, &size) < 0) {
+        return -1;
+    }
+
+    char path[4096];
+    maze_labels_path(maze_path, path, sizeof(path));
+    if (maze_labels_load(labels, path, checksum, size) == 0 && labels->rows == walls->rows && labels->cols == walls->cols) {
+        return 0;
+    }
+    if (labels->label) {
+        maze_labels_free(labels);
+    }
+    maze_labels_build(labels, walls, threads);
+    labels->source_checksum = checksum;
+    labels->source_size = size;
+    maze_labels_save(labels, path);
+    return 0;
+}
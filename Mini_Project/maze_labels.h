@@ -0,0 +1,47 @@
+#ifndef MAZE_LABELS_H
+#define MAZE_LABELS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "maze_bits.h"
+
+#define LBL_MAGIC "LBL1"
+#define LBL_VERSION 1
+
+// Connected components of the open cells. Two cells are connected exactly when they carry the
+// same label, so "is there a path from a to b?" is two lookups. A component's label is its first
+// cell in row-major order, so the map is the same whatever the thread count.
+// Cells are linear bitmap indices (row * stride + col).
+struct maze_labels {
+    int rows, cols, stride;
+    int num_components;
+    int32_t* label;            // First cell of each cell's component, -1 for walls and padding
+    uint64_t source_checksum;  // Checksum of the maze file the labels were built from
+    uint64_t source_size;
+};
+
+// Label a sealed wall bitmap on threads threads. Each thread runs union-find over its own strip
+// of rows: open runs are linked along the row, and to the row above once per stretch where the
+// two rows are both open (found 64 cells at a time from the bitmap words). The strips are then
+// joined across their boundary rows, and every thread labels its own strip again.
+void maze_labels_build(struct maze_labels* labels, const struct maze_bitmap* walls, int threads);
+void maze_labels_free(struct maze_labels* labels);
+
+// Save/load the labels next to the maze. Load fails (returns -1) if the file is missing,
+// malformed, or was built from a different maze file. Both print a message on error.
+int maze_labels_save(const struct maze_labels* labels, const char* path);
+int maze_labels_load(struct maze_labels* labels, const char* path, uint64_t source_checksum, uint64_t source_size);
+
+// Derive the label file name from the maze file name: maze.txt -> maze.txt.lbl
+void maze_labels_path(const char* maze_path, char* out, size_t size);
+
+// Load the labels cached for maze_path, or build and save them. Returns -1 if the maze file
+// cannot be read.
+int maze_labels_prepare(struct maze_labels* labels, const char* maze_path, const struct maze_bitmap* walls, int threads);
+
+// 1 if a and b are open cells of the same component
+static inline int maze_labels_connected(const struct maze_labels* labels, int a, int b) {
+    return labels->label[a] >= 0 && labels->label[a] == labels->label[b];
+}
+
+#endif
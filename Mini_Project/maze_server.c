@@ -0,0 +1,294 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "maze_core.h"
+#include "maze_bits.h"
+#include "maze_io.h"
+#include "maze_cache.h"
+
+// Resident solver: keeps recently used mazes in an LRU cache and answers A* queries over a
+// Unix domain socket from a pool of threads. One request per line, one reply per line:
+//
+//   length <maze file> [start_row start_col goal_row goal_col]  -> ok <length>
+//   path <maze file> [start_row start_col goal_row goal_col]    -> ok <length> <moves>
+//   stats                                                       -> ok queries ... p50 ... p99 ...
+//
+// Without coordinates the maze's own 's' and 'g' are used. Length is -1 when there is no
+// path, moves are 'U'/'D'/'L'/'R', and bad requests get "error <message>". Each connection is
+// served by one pool thread until the client closes it. Ctrl-C prints the latency summary.
+//
+// Usage: maze_server <socket path> [threads] [cached mazes]
+
+#define SERVER_QUEUE 64           // Accepted connections waiting for a pool thread
+#define LATENCY_SAMPLES 65536     // Most recent query latencies kept for percentiles
+
+struct maze_cache cache;
+
+// Accepted connections handed from the listening thread to the pool
+int queue[SERVER_QUEUE];
+int queue_head, queue_count;
+pthread_mutex_t queue_lock = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t queue_ready = PTHREAD_COND_INITIALIZER;
+pthread_cond_t queue_space = PTHREAD_COND_INITIALIZER;
+
+// Query latencies in microseconds, a ring of the most recent samples
+double latencies[LATENCY_SAMPLES];
+long long queries_served;
+pthread_mutex_t latency_lock = PTHREAD_MUTEX_INITIALIZER;
+
+volatile sig_atomic_t stopping = 0;
+
+double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+void record_latency(double seconds) {
+    pthread_mutex_lock(&latency_lock);
+    latencies[queries_served % LATENCY_SAMPLES] = seconds * 1e6;
+    queries_served++;
+    pthread_mutex_unlock(&latency_lock);
+}
+
+int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Function to format the query count, cache counters and p50/p99 latency
+void format_stats(char *out, size_t size) {
+    static double sorted[LATENCY_SAMPLES];
+    static pthread_mutex_t sort_lock = PTHREAD_MUTEX_INITIALIZER;
+
+    pthread_mutex_lock(&sort_lock);
+    pthread_mutex_lock(&latency_lock);
+    long long served = queries_served;
+    int n = served < LATENCY_SAMPLES ? (int)served : LATENCY_SAMPLES;
+    memcpy(sorted, latencies, n * sizeof(double));
+    pthread_mutex_unlock(&latency_lock);
+    qsort(sorted, n, sizeof(double), compare_doubles);
+    double p50 = n ? sorted[(n - 1) / 2] : 0, p99 = n ? sorted[(int)((n - 1) * 0.99)] : 0;
+    pthread_mutex_unlock(&sort_lock);
+
+    pthread_mutex_lock(&cache.lock);
+    snprintf(out, size, "queries %lld hits %lld misses %lld evictions %lld cached %d p50 %.1f us p99 %.1f us",
+             served, cache.hits, cache.misses, cache.evictions, cache.count, p50, p99);
+    pthread_mutex_unlock(&cache.lock);
+}
+
+// Function to answer one length/path request whose arguments follow in the strtok_r state;
+// the reply is written to out without a newline
+void answer_query(char **arguments, bool with_moves, FILE *out) {
+    char *maze_path = strtok_r(NULL, " \t\r\n", arguments);
+    char *fields[5];
+    int count = 0;
+    while (count < 5 && (fields[count] = strtok_r(NULL, " \t\r\n", arguments)) != NULL) {
+        count++;
+    }
+    if (!maze_path || (count != 0 && count != 4)) {
+        fprintf(out, "error expected <maze file> [start_row start_col goal_row goal_col]");
+        return;
+    }
+
+    struct cached_maze *entry = maze_cache_get(&cache, maze_path);
+    if (!entry) {
+        fprintf(out, "error cannot read %s", maze_path);
+        return;
+    }
+
+    int start = entry->start, goal = entry->goal;
+    if (count == 4) {
+        int cell[4];
+        for (int i = 0; i < 4; i++) {
+            cell[i] = atoi(fields[i]);
+        }
+        if (cell[0] < 0 || cell[0] >= entry->rows || cell[1] < 0 || cell[1] >= entry->cols ||
+            cell[2] < 0 || cell[2] >= entry->rows || cell[3] < 0 || cell[3] >= entry->cols) {
+            fprintf(out, "error start and goal must be inside the %d x %d maze", entry->rows, entry->cols);
+            maze_cache_release(&cache, entry);
+            return;
+        }
+        start = maze_bit_index(&entry->walls, cell[0], cell[1]);
+        goal = maze_bit_index(&entry->walls, cell[2], cell[3]);
+    } else if (start < 0 || goal < 0) {
+        fprintf(out, "error %s has no start or goal", maze_path);
+        maze_cache_release(&cache, entry);
+        return;
+    }
+
+    struct AStarContext *context = maze_cache_borrow(&cache, entry);
+    int length = aStarQuery(context, start, goal);
+    fprintf(out, "ok %d", length);
+    if (with_moves && length >= 0) {
+        char *moves = (char *)malloc(length + 1);
+        if (!moves) {
+            printf("Error: Cannot allocate a path.\n");
+            exit(EXIT_FAILURE);
+        }
+        aStarPathMoves(context, start, goal, moves);
+        fputc(' ', out);
+        fputs(moves, out);
+        free(moves);
+    }
+    maze_cache_return(&cache, entry, context);
+    maze_cache_release(&cache, entry);
+}
+
+// Function to serve one connection until the client closes it
+void serve_connection(int fd) {
+    FILE *in = fdopen(fd, "r");
+    int out_fd = dup(fd);
+    FILE *out = out_fd < 0 ? NULL : fdopen(out_fd, "w");
+    if (!in || !out) {
+        printf("Error: Cannot open a connection stream.\n");
+        if (in) {
+            fclose(in);
+        } else {
+            close(fd);
+        }
+        if (out_fd >= 0 && !out) {
+            close(out_fd);
+        }
+        return;
+    }
+
+    char *line = NULL;
+    size_t capacity = 0;
+    while (getline(&line, &capacity, in) > 0) {
+        double begin = now_seconds();
+        char *arguments;
+        char *command = strtok_r(line, " \t\r\n", &arguments);
+        if (!command) {
+            continue;
+        }
+        if (strcmp(command, "length") == 0 || strcmp(command, "path") == 0) {
+            answer_query(&arguments, strcmp(command, "path") == 0, out);
+            fputc('\n', out);
+            if (fflush(out) != 0) {
+                break;
+            }
+            record_latency(now_seconds() - begin);
+        } else if (strcmp(command, "stats") == 0) {
+            char stats[256];
+            format_stats(stats, sizeof(stats));
+            fprintf(out, "ok %s\n", stats);
+            if (fflush(out) != 0) {
+                break;
+            }
+        } else {
+            fprintf(out, "error unknown command %s\n", command);
+            if (fflush(out) != 0) {
+                break;
+            }
+        }
+    }
+    free(line);
+    fclose(out);
+    fclose(in);
+}
+
+// Pool thread: take connections from the queue forever
+void *pool_worker(void *arg) {
+    (void)arg;
+    while (true) {
+        pthread_mutex_lock(&queue_lock);
+        while (queue_count == 0) {
+            pthread_cond_wait(&queue_ready, &queue_lock);
+        }
+        int fd = queue[queue_head];
+        queue_head = (queue_head + 1) % SERVER_QUEUE;
+        queue_count--;
+        pthread_cond_signal(&queue_space);
+        pthread_mutex_unlock(&queue_lock);
+        serve_connection(fd);
+    }
+    return NULL;
+}
+
+void handle_stop(int signal_number) {
+    (void)signal_number;
+    stopping = 1;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2 || argc > 4) {
+        printf("Usage: %s <socket path> [threads] [cached mazes]\n", argv[0]);
+        return 1;
+    }
+    const char *socket_path = argv[1];
+    int threads = argc > 2 ? atoi(argv[2]) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    int capacity = argc > 3 ? atoi(argv[3]) : 8;
+    if (threads < 1) {
+        threads = 1;
+    }
+    maze_cache_init(&cache, capacity);
+
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(socket_path) >= sizeof(address.sun_path)) {
+        printf("Error: Socket path %s is too long.\n", socket_path);
+        return 1;
+    }
+    strcpy(address.sun_path, socket_path);
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(socket_path);
+    if (listener < 0 || bind(listener, (struct sockaddr *)&address, sizeof(address)) < 0 || listen(listener, SOMAXCONN) < 0) {
+        printf("Error: Cannot listen on %s: %s.\n", socket_path, strerror(errno));
+        return 1;
+    }
+
+    // Ctrl-C / SIGTERM interrupt accept; a client that hangs up must not kill the server
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = handle_stop;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    for (int t = 0; t < threads; t++) {
+        pthread_t id;
+        if (pthread_create(&id, NULL, pool_worker, NULL) != 0) {
+            printf("Error: Cannot start pool thread %d.\n", t);
+            return 1;
+        }
+        pthread_detach(id);
+    }
+    printf("Serving %s with %d thread(s), caching up to %d maze(s)\n", socket_path, threads, cache.capacity);
+    fflush(stdout);
+
+    while (!stopping) {
+        int fd = accept(listener, NULL, NULL);
+        if (fd < 0) {
+            if (errno != EINTR) {
+                printf("Error: accept failed: %s.\n", strerror(errno));
+            }
+            continue;
+        }
+        pthread_mutex_lock(&queue_lock);
+        while (queue_count == SERVER_QUEUE) {
+            pthread_cond_wait(&queue_space, &queue_lock);
+        }
+        queue[(queue_head + queue_count) % SERVER_QUEUE] = fd;
+        queue_count++;
+        pthread_cond_signal(&queue_ready);
+        pthread_mutex_unlock(&queue_lock);
+    }
+
+    char stats[256];
+    format_stats(stats, sizeof(stats));
+    printf("\nServed %s\n", stats);
+    close(listener);
+    unlink(socket_path);
+    return 0;
+}
@@ -0,0 +1,253 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "open_list.h"
+
+// Function to create an empty open list able to hold numCells cells
+struct OpenList *createOpenList(int numCells, enum OpenListKind kind) {
+    struct OpenList *list = (struct OpenList *)calloc(1, sizeof(struct OpenList));
+    if (!list) {
+        printf("Error: Cannot allocate open list.\n");
+        exit(EXIT_FAILURE);
+    }
+    list->kind = kind;
+    list->numCells = numCells;
+    list->key = (int *)malloc(numCells * sizeof(int));
+    list->pos = (int *)malloc(numCells * sizeof(int));
+    if (!list->key || !list->pos) {
+        printf("Error: Cannot allocate open list.\n");
+        exit(EXIT_FAILURE);
+    }
+    memset(list->pos, -1, numCells * sizeof(int));
+
+    if (kind == OPEN_LIST_HEAP) {
+        list->heap = (int *)malloc(numCells * sizeof(int));
+        if (!list->heap) {
+            printf("Error: Cannot allocate open list.\n");
+            exit(EXIT_FAILURE);
+        }
+    } else {
+        list->next = (int *)malloc(numCells * sizeof(int));
+        list->prev = (int *)malloc(numCells * sizeof(int));
+        list->numBuckets = 64;
+        list->bucket = (int *)malloc(list->numBuckets * sizeof(int));
+        if (!list->next || !list->prev || !list->bucket) {
+            printf("Error: Cannot allocate open list.\n");
+            exit(EXIT_FAILURE);
+        }
+        memset(list->bucket, -1, list->numBuckets * sizeof(int));
+        list->minBucket = list->numBuckets;
+    }
+    return list;
+}
+
+// Function to release an open list
+void freeOpenList(struct OpenList *list) {
+    if (!list) {
+        return;
+    }
+    free(list->key);
+    free(list->pos);
+    free(list->heap);
+    free(list->next);
+    free(list->prev);
+    free(list->bucket);
+    free(list);
+}
+
+// Function to report the memory held by the list
+long long openListBytes(const struct OpenList *list) {
+    int arrays = list->kind == OPEN_LIST_HEAP ? 3 : 4; // key, pos and heap or next/prev
+    return sizeof(struct OpenList) + (long long)arrays * list->numCells * sizeof(int) + (long long)list->numBuckets * sizeof(int);
+}
+
+// Function to empty the list for reuse; only the cells still open are touched
+void openListClear(struct OpenList *list) {
+    if (list->kind == OPEN_LIST_HEAP) {
+        for (int i = 0; i < list->size; i++) {
+            list->pos[list->heap[i]] = -1;
+        }
+    } else {
+        for (int f = list->minBucket; f < list->numBuckets && list->size > 0; f++) {
+            for (int cell = list->bucket[f]; cell != -1; cell = list->next[cell]) {
+                list->pos[cell] = -1;
+                list->size--;
+            }
+            list->bucket[f] = -1;
+        }
+        list->minBucket = list->numBuckets;
+    }
+    list->size = 0;
+}
+
+bool openListIsEmpty(const struct OpenList *list) {
+    return list->size == 0;
+}
+
+// For the heap pos is the heap slot; for buckets it only marks membership (0)
+bool openListContains(const struct OpenList *list, int cell) {
+    return list->pos[cell] != -1;
+}
+
+// Heap ordering: lower f first, ties go to the lower cell index (same order as a row-major scan)
+static bool heapLess(const struct OpenList *list, int a, int b) {
+    return list->key[a] < list->key[b] || (list->key[a] == list->key[b] && a < b);
+}
+
+static void heapSwap(struct OpenList *list, int i, int j) {
+    int a = list->heap[i], b = list->heap[j];
+    list->heap[i] = b;
+    list->heap[j] = a;
+    list->pos[b] = i;
+    list->pos[a] = j;
+}
+
+static void heapSiftUp(struct OpenList *list, int i) {
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!heapLess(list, list->heap[i], list->heap[parent])) {
+            break;
+        }
+        heapSwap(list, i, parent);
+        i = parent;
+    }
+}
+
+static void heapSiftDown(struct OpenList *list, int i) {
+    while (true) {
+        int left = 2 * i + 1, right = left + 1, smallest = i;
+        if (left < list->size && heapLess(list, list->heap[left], list->heap[smallest])) {
+            smallest = left;
+        }
+        if (right < list->size && heapLess(list, list->heap[right], list->heap[smallest])) {
+            smallest = right;
+        }
+        if (smallest == i) {
+            break;
+        }
+        heapSwap(list, i, smallest);
+        i = smallest;
+    }
+}
+
+static void bucketUnlink(struct OpenList *list, int cell) {
+    int f = list->key[cell];
+    if (list->prev[cell] != -1) {
+        list->next[list->prev[cell]] = list->next[cell];
+    } else {
+        list->bucket[f] = list->next[cell];
+    }
+    if (list->next[cell] != -1) {
+        list->prev[list->next[cell]] = list->prev[cell];
+    }
+}
+
+static void bucketLink(struct OpenList *list, int cell, int f) {
+    if (f >= list->numBuckets) {
+        int newSize = list->numBuckets;
+        while (newSize <= f) {
+            newSize *= 2;
+        }
+        int *grown = (int *)realloc(list->bucket, newSize * sizeof(int));
+        if (!grown) {
+            printf("Error: Cannot grow bucket queue.\n");
+            exit(EXIT_FAILURE);
+        }
+        memset(grown + list->numBuckets, -1, (newSize - list->numBuckets) * sizeof(int));
+        if (list->minBucket == list->numBuckets) {
+            list->minBucket = newSize;
+        }
+        list->bucket = grown;
+        list->numBuckets = newSize;
+    }
+    list->key[cell] = f;
+    list->prev[cell] = -1;
+    list->next[cell] = list->bucket[f];
+    if (list->bucket[f] != -1) {
+        list->prev[list->bucket[f]] = cell;
+    }
+    list->bucket[f] = cell;
+    if (f < list->minBucket) {
+        list->minBucket = f;
+    }
+}
+
+// Function to add a cell with priority f, or lower its priority if it is already open
+void openListPush(struct OpenList *list, int cell, int f) {
+    if (f < 0) {
+        printf("Error: Negative f value %d in open list.\n", f);
+        exit(EXIT_FAILURE);
+    }
+#ifdef MAZE_STATS
+    list->pushes++;
+#endif
+
+    if (list->kind == OPEN_LIST_HEAP) {
+        if (list->pos[cell] == -1) {
+            list->key[cell] = f;
+            list->pos[cell] = list->size;
+            list->heap[list->size++] = cell;
+            heapSiftUp(list, list->pos[cell]);
+        } else if (f < list->key[cell]) {
+            list->key[cell] = f;
+            heapSiftUp(list, list->pos[cell]);
+        }
+        return;
+    }
+
+    if (list->pos[cell] == -1) {
+        list->pos[cell] = 0;
+        list->size++;
+    } else if (f < list->key[cell]) {
+        bucketUnlink(list, cell);
+    } else {
+        return;
+    }
+    bucketLink(list, cell, f);
+}
+
+// Function to remove and return the open cell with the smallest f (-1 if the list is empty)
+int openListPop(struct OpenList *list) {
+    if (list->size == 0) {
+        return -1;
+    }
+#ifdef MAZE_STATS
+    list->pops++;
+#endif
+
+    int cell;
+    if (list->kind == OPEN_LIST_HEAP) {
+        cell = list->heap[0];
+        list->size--;
+        if (list->size > 0) {
+            heapSwap(list, 0, list->size);
+            heapSiftDown(list, 0);
+        }
+    } else {
+        while (list->bucket[list->minBucket] == -1) {
+            list->minBucket++;
+        }
+        cell = list->bucket[list->minBucket];
+        bucketUnlink(list, cell);
+        list->size--;
+    }
+    list->pos[cell] = -1;
+    return cell;
+}
+
+const char *openListKindName(enum OpenListKind kind) {
+    return kind == OPEN_LIST_HEAP ? "heap" : "bucket";
+}
+
+// Function to parse "heap" or "bucket" into an open list kind
+bool parseOpenListKind(const char *name, enum OpenListKind *kind) {
+    if (strcmp(name, "heap") == 0) {
+        *kind = OPEN_LIST_HEAP;
+        return true;
+    }
+    if (strcmp(name, "bucket") == 0) {
+        *kind = OPEN_LIST_BUCKET;
+        return true;
+    }
+    return false;
+}
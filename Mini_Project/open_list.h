@@ -0,0 +1,41 @@
+#ifndef OPEN_LIST_H
+#define OPEN_LIST_H
+
+#include <stdbool.h>
+
+// Open list implementations for A*; cells are identified by their linear index (row * numCols + col)
+enum OpenListKind {
+    OPEN_LIST_HEAP,   // Indexed binary heap, O(log N) push/pop/decrease-key
+    OPEN_LIST_BUCKET  // Bucket queue keyed on integer f, O(1) push/decrease-key
+};
+
+struct OpenList {
+    enum OpenListKind kind;
+    int numCells;
+    int size;      // Number of cells currently in the open list
+    int *key;      // f value of each cell while it is in the open list
+    int *pos;      // Heap slot of each cell (-1 when not in the heap)
+    int *heap;     // Heap of cell indices ordered by (f, cell)
+    int *next;     // Bucket queue: next/previous cell in the same bucket
+    int *prev;
+    int *bucket;   // Bucket queue: first cell of each f bucket (-1 when empty)
+    int numBuckets;
+    int minBucket; // Bucket queue: no bucket below this index is non-empty
+#ifdef MAZE_STATS
+    long long pushes; // Push/decrease-key calls so far, for comparing search strategies
+    long long pops;   // Cells popped so far
+#endif
+};
+
+struct OpenList *createOpenList(int numCells, enum OpenListKind kind);
+void freeOpenList(struct OpenList *list);
+void openListClear(struct OpenList *list);
+long long openListBytes(const struct OpenList *list);
+bool openListIsEmpty(const struct OpenList *list);
+bool openListContains(const struct OpenList *list, int cell);
+void openListPush(struct OpenList *list, int cell, int f);
+int openListPop(struct OpenList *list);
+const char *openListKindName(enum OpenListKind kind);
+bool parseOpenListKind(const char *name, enum OpenListKind *kind);
+
+#endif
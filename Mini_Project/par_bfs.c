@@ -0,0 +1,212 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "par_bfs.h"
+#include "search_stats.h"
+
+#define PAR_BFS_CHUNK 256 // Frontier cells taken per grab
+
+// Next-frontier buffer owned by one thread
+struct par_buffer {
+    int* cells;
+    int size;
+    int capacity;
+};
+
+// One thread's share of the current level, padded so cursors do not share a cache line
+struct par_range {
+    atomic_int next;
+    int end;
+    char pad[64 - sizeof(atomic_int) - sizeof(int)];
+};
+
+// State shared by the pool for the whole search
+struct par_shared {
+    const struct maze_bitmap* walls;
+    int* dist;
+    atomic_int* parent;
+    int threads;
+    int* frontier[2];           // Current and next frontier, alternating by level
+    int frontier_size;
+    int level;
+    long long reached;
+    struct par_range* ranges;
+    struct par_buffer* buffers;
+    int* offsets;               // Where each thread's buffer goes in the next frontier
+    pthread_barrier_t barrier;
+#ifdef MAZE_STATS
+    struct search_stats stats;  // Updated by worker 0 between levels
+#endif
+};
+
+struct par_worker {
+    struct par_shared* shared;
+    int id;
+};
+
+static void buffer_push(struct par_buffer* buffer, int cell) {
+    if (buffer->size == buffer->capacity) {
+        buffer->capacity = buffer->capacity ? buffer->capacity * 2 : 1024;
+        buffer->cells = (int*)realloc(buffer->cells, buffer->capacity * sizeof(int));
+        if (!buffer->cells) {
+            printf("Error: Cannot grow a frontier buffer.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    buffer->cells[buffer->size++] = cell;
+}
+
+// Split the current frontier evenly between the threads
+static void split_frontier(struct par_shared* shared) {
+    for (int t = 0; t < shared->threads; t++) {
+        atomic_store(&shared->ranges[t].next, (int)((long long)shared->frontier_size * t / shared->threads));
+        shared->ranges[t].end = (int)((long long)shared->frontier_size * (t + 1) / shared->threads);
+    }
+}
+
+// Expand every frontier cell in [begin, end) into this thread's buffer
+static void expand(struct par_shared* shared, const int* frontier, int begin, int end, struct par_buffer* buffer) {
+    const struct maze_bitmap* walls = shared->walls;
+    int offsets[4] = { -walls->stride, walls->stride, -1, 1 };
+    int next_dist = shared->level + 1;
+    for (int i = begin; i < end; i++) {
+        int cell = frontier[i];
+        for (int d = 0; d < 4; d++) {
+            int next = cell + offsets[d];
+            if (maze_bit_test(walls, next) || atomic_load_explicit(&shared->parent[next], memory_order_relaxed) != -1) {
+                continue;
+            }
+            int unclaimed = -1;
+            if (atomic_compare_exchange_strong_explicit(&shared->parent[next], &unclaimed, cell,
+                                                        memory_order_relaxed, memory_order_relaxed)) {
+                shared->dist[next] = next_dist;
+                buffer_push(buffer, next);
+            }
+        }
+    }
+}
+
+static void* run_worker(void* arg) {
+    struct par_worker* worker = (struct par_worker*)arg;
+    struct par_shared* shared = worker->shared;
+    int id = worker->id, threads = shared->threads;
+    struct par_buffer* buffer = &shared->buffers[id];
+
+    for (;;) {
+        const int* frontier = shared->frontier[shared->level & 1];
+        buffer->size = 0;
+
+        // Own range first, then steal from the others, a chunk at a time
+        for (int k = 0; k < threads; k++) {
+            struct par_range* range = &shared->ranges[(id + k) % threads];
+            for (;;) {
+                int begin = atomic_fetch_add(&range->next, PAR_BFS_CHUNK);
+                if (begin >= range->end) {
+                    break;
+                }
+                expand(shared, frontier, begin, begin + PAR_BFS_CHUNK < range->end ? begin + PAR_BFS_CHUNK : range->end, buffer);
+            }
+        }
+        pthread_barrier_wait(&shared->barrier);
+
+        // One thread lays out the next frontier
+        if (id == 0) {
+            int total = 0;
+            for (int t = 0; t < threads; t++) {
+                shared->offsets[t] = total;
+                total += shared->buffers[t].size;
+            }
+            shared->frontier_size = total;
+            shared->reached += total;
+            STATS_MAX(shared->stats, peak_open, total);
+            shared->level++;
+            split_frontier(shared);
+        }
+        pthread_barrier_wait(&shared->barrier);
+        if (shared->frontier_size == 0) {
+            break;
+        }
+
+        // Every thread copies its own buffer into place (an empty one may not be allocated yet)
+        if (buffer->size > 0) {
+            memcpy(shared->frontier[shared->level & 1] + shared->offsets[id], buffer->cells, buffer->size * sizeof(int));
+        }
+        pthread_barrier_wait(&shared->barrier);
+    }
+    return NULL;
+}
+
+long long par_bfs(const struct maze_bitmap* walls, int start, int threads, int* dist, atomic_int* parent) {
+    int numCells = walls->rows * walls->stride;
+    if (threads < 1) {
+        threads = 1;
+    }
+    for (int i = 0; i < numCells; i++) {
+        dist[i] = -1;
+        atomic_init(&parent[i], -1);
+    }
+    dist[start] = 0;
+    atomic_store(&parent[start], start);
+
+    struct par_shared shared;
+    STATS_BEGIN(shared.stats, "par_bfs");
+    shared.walls = walls;
+    shared.dist = dist;
+    shared.parent = parent;
+    shared.threads = threads;
+    shared.frontier[0] = (int*)malloc(numCells * sizeof(int));
+    shared.frontier[1] = (int*)malloc(numCells * sizeof(int));
+    shared.ranges = (struct par_range*)calloc(threads, sizeof(struct par_range));
+    shared.buffers = (struct par_buffer*)calloc(threads, sizeof(struct par_buffer));
+    shared.offsets = (int*)malloc(threads * sizeof(int));
+    struct par_worker* workers = (struct par_worker*)malloc(threads * sizeof(struct par_worker));
+    pthread_t* ids = (pthread_t*)malloc(threads * sizeof(pthread_t));
+    if (!shared.frontier[0] || !shared.frontier[1] || !shared.ranges || !shared.buffers ||
+        !shared.offsets || !workers || !ids) {
+        printf("Error: Cannot allocate parallel BFS state.\n");
+        exit(EXIT_FAILURE);
+    }
+    shared.frontier[0][0] = start;
+    shared.frontier_size = 1;
+    shared.level = 0;
+    shared.reached = 1;
+    split_frontier(&shared);
+    pthread_barrier_init(&shared.barrier, NULL, threads);
+    STATS_MAX(shared.stats, peak_open, 1);
+    STATS_PHASE(shared.stats, "search");
+
+    // The calling thread is worker 0
+    for (int t = 0; t < threads; t++) {
+        workers[t].shared = &shared;
+        workers[t].id = t;
+    }
+    for (int t = 1; t < threads; t++) {
+        if (pthread_create(&ids[t], NULL, run_worker, &workers[t]) != 0) {
+            printf("Error: Cannot start BFS worker %d.\n", t);
+            exit(EXIT_FAILURE);
+        }
+    }
+    run_worker(&workers[0]);
+    for (int t = 1; t < threads; t++) {
+        pthread_join(ids[t], NULL);
+    }
+
+    pthread_barrier_destroy(&shared.barrier);
+    STATS_ADD(shared.stats, expanded, shared.reached);
+    STATS_ADD(shared.stats, generated, shared.reached);
+    STATS_ADD(shared.stats, state_bytes, 2LL * numCells * sizeof(int));
+    for (int t = 0; t < threads; t++) {
+        STATS_ADD(shared.stats, state_bytes, (long long)shared.buffers[t].capacity * sizeof(int));
+        free(shared.buffers[t].cells);
+    }
+    STATS_REPORT(shared.stats);
+    free(shared.frontier[0]);
+    free(shared.frontier[1]);
+    free(shared.ranges);
+    free(shared.buffers);
+    free(shared.offsets);
+    free(workers);
+    free(ids);
+    return shared.reached;
+}
@@ -0,0 +1,19 @@
+#ifndef PAR_BFS_H
+#define PAR_BFS_H
+
+#include <stdatomic.h>
+#include "maze_bits.h"
+
+// Level-synchronous parallel BFS over a sealed wall bitmap. Each frontier level is split into
+// one range per thread; threads take chunks from their own range and steal chunks from the
+// others' once it runs dry. A cell is claimed by the compare-and-swap of its parent entry from
+// -1, so each cell is expanded exactly once. Newly claimed cells go into per-thread buffers
+// that are concatenated into the next frontier between levels.
+//
+// dist and parent hold walls->rows * walls->stride entries, indexed like the bitmap. On return
+// dist[cell] is the number of moves from start (-1 if unreachable) and parent[cell] the cell it
+// was reached from (start is its own parent, -1 if unreachable).
+// Returns the number of cells reached, start included.
+long long par_bfs(const struct maze_bitmap* walls, int start, int threads, int* dist, atomic_int* parent);
+
+#endif
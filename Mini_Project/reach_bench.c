@@ -0,0 +1,250 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "maze_core.h"
+#include "maze_bits.h"
+#include "maze_io.h"
+#include "Astar_code.h"
+#include "dfs_engine.h"
+#include "reach_engine.h"
+
+// Cost of the "can the goal be reached at all?" check: the DFS the solver used to run for it
+// (dfs_iterative) against the bit-parallel flood fill (reach_flood) and its level-synchronous
+// version (reach_layers), which also gives the path length. All three must agree on every map,
+// and the layer count must equal the A* length. The unreachable map is the DFS's worst case:
+// it has to visit the start's whole component, one cell at a time, before giving up.
+//
+// Usage: reach_bench [size | maze file] [--reps 10] [--seed 1]
+// Default: generated 1001 x 1001 maps, a perfect maze, an open room with 10% walls and the
+// same room with its goal walled in.
+
+#define REACH_MAX_REPS 1000
+
+double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+unsigned long long rng_state;
+
+unsigned next_random(void) {
+    rng_state = rng_state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (unsigned)(rng_state >> 33);
+}
+
+// One map to check, start and goal as linear bitmap indices
+struct reach_case {
+    const char *name;
+    struct maze_bitmap walls;
+    int start, goal;
+};
+
+// Perfect maze carved by a randomised backtracker on the odd cells, start at (1, 1) and goal
+// in the last odd row and column
+void generate_perfect(struct reach_case *c, int size) {
+    struct maze_bitmap *walls = &c->walls;
+    maze_bitmap_alloc(walls, size, size);
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            maze_bit_set(walls, maze_bit_index(walls, i, j));
+        }
+    }
+    int *stack = (int *)malloc((size_t)size * size * sizeof(int));
+    if (!stack) {
+        printf("Error: Cannot allocate the generator stack.\n");
+        exit(EXIT_FAILURE);
+    }
+    const int steps[4][2] = { {-2, 0}, {2, 0}, {0, -2}, {0, 2} };
+    int top = 0;
+    stack[top++] = maze_bit_index(walls, 1, 1);
+    maze_bit_clear(walls, stack[0]);
+    while (top > 0) {
+        int cell = stack[top - 1];
+        int row = cell / walls->stride, col = cell % walls->stride;
+        int options[4], count = 0;
+        for (int d = 0; d < 4; d++) {
+            int r = row + steps[d][0], k = col + steps[d][1];
+            if (r > 0 && r < size - 1 && k > 0 && k < size - 1 && maze_bit_test(walls, maze_bit_index(walls, r, k))) {
+                options[count++] = d;
+            }
+        }
+        if (count == 0) {
+            top--;
+            continue;
+        }
+        int d = options[next_random() % count];
+        maze_bit_clear(walls, maze_bit_index(walls, row + steps[d][0] / 2, col + steps[d][1] / 2));
+        int next = maze_bit_index(walls, row + steps[d][0], col + steps[d][1]);
+        maze_bit_clear(walls, next);
+        stack[top++] = next;
+    }
+    free(stack);
+    maze_bitmap_seal(walls);
+    int last = size % 2 ? size - 2 : size - 3;
+    c->name = "perfect";
+    c->start = maze_bit_index(walls, 1, 1);
+    c->goal = maze_bit_index(walls, last, last);
+}
+
+// Open room with about 10% of the cells walled, start and goal in opposite corners. cut walls
+// in the goal's two neighbours as well.
+void generate_room(struct reach_case *c, int size, int cut) {
+    struct maze_bitmap *walls = &c->walls;
+    maze_bitmap_alloc(walls, size, size);
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            if (next_random() % 10 == 0) {
+                maze_bit_set(walls, maze_bit_index(walls, i, j));
+            }
+        }
+    }
+    c->start = maze_bit_index(walls, 0, 0);
+    c->goal = maze_bit_index(walls, size - 1, size - 1);
+    maze_bit_clear(walls, c->start);
+    maze_bit_clear(walls, c->goal);
+    if (cut) {
+        maze_bit_set(walls, maze_bit_index(walls, size - 2, size - 1));
+        maze_bit_set(walls, maze_bit_index(walls, size - 1, size - 2));
+    }
+    maze_bitmap_seal(walls);
+    c->name = cut ? "room, cut" : "room";
+}
+
+int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+double median_ms(double *seconds, int n) {
+    qsort(seconds, n, sizeof(double), compare_doubles);
+    return 1e3 * (n % 2 ? seconds[n / 2] : (seconds[n / 2 - 1] + seconds[n / 2]) / 2);
+}
+
+// Time the three checks on one map and verify they agree. Returns 0, or -1 on a mismatch.
+int run_case(struct reach_case *c, int reps, double *dfs_time, double *flood_time, double *layers_time) {
+    static const int dfs_directions[4][2] = { {0, -1}, {1, 0}, {0, 1}, {-1, 0} };
+    struct maze_bitmap *walls = &c->walls;
+    struct maze_bitmap visited, path;
+    maze_bitmap_alloc(&visited, walls->rows, walls->cols);
+    maze_bitmap_alloc(&path, walls->rows, walls->cols);
+    int found = 0, flooded = 0, distance = -1;
+    struct reach_stats flood_stats, layer_stats;
+    for (int rep = 0; rep < reps; rep++) {
+        // Every check starts from clear bitmaps, so clearing is part of its cost
+        double t0 = now_seconds();
+        maze_bitmap_clear(&visited);
+        maze_bitmap_clear(&path);
+        found = dfs_iterative(walls, &visited, &path, c->start, c->goal, dfs_directions);
+        double t1 = now_seconds();
+        maze_bitmap_clear(&visited);
+        flooded = reach_flood(walls, c->start, c->goal, &visited, &flood_stats);
+        double t2 = now_seconds();
+        maze_bitmap_clear(&visited);
+        distance = reach_layers(walls, c->start, c->goal, &visited, &layer_stats);
+        double t3 = now_seconds();
+        dfs_time[rep] = t1 - t0;
+        flood_time[rep] = t2 - t1;
+        layers_time[rep] = t3 - t2;
+    }
+
+    // An ALT build needs landmark tables for the reference A*
+    struct Landmarks landmarks = {0};
+    if (heuristicNeedsLandmarks(heuristicKind)) {
+        buildLandmarks(&landmarks, walls, ALT_DEFAULT_LANDMARKS);
+        heuristicLandmarks = &landmarks;
+    }
+    struct AStarContext *context = createAStarContext(walls, openListKind);
+    int length = aStarQuery(context, c->start, c->goal);
+    freeAStarContext(context);
+    freeLandmarks(&landmarks);
+    heuristicLandmarks = NULL;
+    maze_bitmap_free(&visited);
+    maze_bitmap_free(&path);
+    if (found != flooded || length != distance) {
+        printf("Error: %s: dfs %s, flood %s, %d layers, A* length %d.\n", c->name, found ? "reached" : "failed",
+               flooded ? "reached" : "failed", distance, length);
+        return -1;
+    }
+
+    double dfs_ms = median_ms(dfs_time, reps), flood_ms = median_ms(flood_time, reps);
+    double layers_ms = median_ms(layers_time, reps);
+    printf("%-10s %5d x %-5d %9s %10.3f %10.3f %7.1fx %8lld %10.3f %9d\n", c->name, walls->rows, walls->cols,
+           found ? "yes" : "no", dfs_ms, flood_ms, flood_ms > 0 ? dfs_ms / flood_ms : 0, flood_stats.sweeps,
+           layers_ms, distance);
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    const char *source = "1001";
+    int reps = 10;
+    rng_state = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--reps") == 0 && i + 1 < argc) {
+            reps = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            rng_state = strtoull(argv[++i], NULL, 10);
+        } else if (argv[i][0] != '-') {
+            source = argv[i];
+        } else {
+            printf("Usage: %s [size | maze file] [--reps 10] [--seed 1]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (reps < 1 || reps > REACH_MAX_REPS) {
+        printf("Error: --reps must be between 1 and %d.\n", REACH_MAX_REPS);
+        return 1;
+    }
+
+    // A number is a set of generated maps of that size; anything else is a maze file with 's' and 'g'
+    struct reach_case cases[3];
+    int count = 0;
+    char *end;
+    long size = strtol(source, &end, 10);
+    if (*end == '\0') {
+        if (size < 5 || size > 20000) {
+            printf("Error: Size %ld is out of range.\n", size);
+            return 1;
+        }
+        generate_perfect(&cases[count++], (int)size);
+        generate_room(&cases[count++], (int)size, 0);
+        generate_room(&cases[count++], (int)size, 1);
+    } else {
+        struct maze_file file;
+        if (maze_file_open(&file, source) < 0) {
+            return 1;
+        }
+        struct reach_case *c = &cases[count++];
+        maze_file_to_bitmap(&file, &c->walls, 'x');
+        if (file.start_row < 0 || file.goal_row < 0) {
+            printf("Error: %s has no start or goal.\n", source);
+            return 1;
+        }
+        c->name = "file";
+        c->start = maze_bit_index(&c->walls, file.start_row, file.start_col);
+        c->goal = maze_bit_index(&c->walls, file.goal_row, file.goal_col);
+        maze_file_close(&file);
+    }
+
+    double *dfs_time = (double *)malloc(reps * sizeof(double));
+    double *flood_time = (double *)malloc(reps * sizeof(double));
+    double *layers_time = (double *)malloc(reps * sizeof(double));
+    if (!dfs_time || !flood_time || !layers_time) {
+        printf("Error: Cannot allocate benchmark state.\n");
+        return 1;
+    }
+    printf("%-10s %13s %9s %10s %10s %8s %8s %10s %9s\n", "map", "size", "reachable", "dfs ms", "flood ms",
+           "speedup", "sweeps", "layers ms", "distance");
+    int status = 0;
+    for (int i = 0; i < count; i++) {
+        if (run_case(&cases[i], reps, dfs_time, flood_time, layers_time) < 0) {
+            status = 1;
+        }
+        maze_bitmap_free(&cases[i].walls);
+    }
+    free(dfs_time);
+    free(flood_time);
+    free(layers_time);
+    return status;
+}
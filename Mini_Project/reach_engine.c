@@ -0,0 +1,316 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "reach_engine.h"
+#include "search_stats.h"
+
+// Grow a row along its open runs, both ways, 64 cells per step, starting from the words
+// first..last that gained cells. Towards higher columns, adding the seeds to the open bits
+// starts a carry at the lowest seed of each run that ripples to the run's end (and into the next
+// word), so the carries into each bit are the cells reached. Towards lower columns a shift/and
+// fill with doubling distances does the same in six steps. The rest of the row is already closed,
+// so the passes stop at the first word past the gained ones that takes no carry. Sets *lo and *hi
+// to the words that may have changed.
+static void fill_row(uint64_t* row, const uint64_t* open, int first, int last, int words, int* lo, int* hi) {
+    uint64_t carry = 0;
+    int w;
+    for (w = first; w < words && (w <= last || carry); w++) {
+        uint64_t o = open[w], s = row[w];
+        uint64_t sum = o + s;
+        uint64_t total = sum + carry;
+        carry = (sum < o) | (total < sum);
+        row[w] = s | ((total ^ o ^ s) & o);
+    }
+    *hi = w - 1;
+    carry = 0;
+    for (w = *hi; w >= 0 && (w >= first || carry); w--) {
+        uint64_t g = open[w], x = row[w] | ((carry << 63) & g);
+        x |= g & (x >> 1);
+        g &= g >> 1;
+        x |= g & (x >> 2);
+        g &= g >> 2;
+        x |= g & (x >> 4);
+        g &= g >> 4;
+        x |= g & (x >> 8);
+        g &= g >> 8;
+        x |= g & (x >> 16);
+        g &= g >> 16;
+        x |= g & (x >> 32);
+        carry = x & 1;
+        row[w] = x;
+    }
+    *lo = w + 1;
+}
+
+// Take in what the rows above and below reached in words *lo..*hi, then fill. Rows are always
+// kept closed under horizontal moves, so a row that gains nothing from its neighbours is left as
+// it is. Returns 1 if the row changed, with *lo and *hi set to the words that changed.
+static int merge_row(uint64_t* row, const uint64_t* above, const uint64_t* below, const uint64_t* open,
+                     int words, int* lo, int* hi) {
+    int first = -1, last = -1;
+    for (int w = *lo; w <= *hi; w++) {
+        uint64_t x = row[w] | ((above[w] | below[w]) & open[w]);
+        if (x != row[w]) {
+            row[w] = x;
+            first = first < 0 ? w : first;
+            last = w;
+        }
+    }
+    if (first < 0) {
+        return 0;
+    }
+    fill_row(row, open, first, last, words, lo, hi);
+    return 1;
+}
+
+// Mark words first..last of row r for merging, on top of any already marked. Returns 1 if the
+// row was not pending yet.
+static int mark_pending(unsigned char* pending, int* span, int r, int first, int last) {
+    if (!pending[r]) {
+        pending[r] = 1;
+        span[2 * r] = first;
+        span[2 * r + 1] = last;
+        return 1;
+    }
+    span[2 * r] = first < span[2 * r] ? first : span[2 * r];
+    span[2 * r + 1] = last > span[2 * r + 1] ? last : span[2 * r + 1];
+    return 0;
+}
+
+static long long count_cells(const struct maze_bitmap* bits) {
+    long long count = 0;
+    for (long long w = 0; w < (long long)bits->rows * bits->words_per_row; w++) {
+        count += __builtin_popcountll(bits->words[w]);
+    }
+    return count;
+}
+
+int reach_flood(const struct maze_bitmap* walls, int start, int goal, struct maze_bitmap* reached,
+                struct reach_stats* stats) {
+    struct reach_stats local = { 0, 0, 0 };
+    if (maze_bit_test(walls, start)) {
+        if (stats) {
+            *stats = local;
+        }
+        return 0;
+    }
+    STATS_DECLARE(counters, "flood");
+
+    int rows = walls->rows, words = walls->words_per_row;
+    uint64_t* open = (uint64_t*)malloc((size_t)rows * words * sizeof(uint64_t));
+    unsigned char* pending = (unsigned char*)calloc(rows, 1);
+    unsigned char* queued = (unsigned char*)calloc(rows, 1);   // Row is on next_queue
+    int* span = (int*)malloc(2 * rows * sizeof(int));   // Words of a pending row next to a change
+    int* queue = (int*)malloc(rows * sizeof(int));      // Pending rows of this sweep
+    int* next_queue = (int*)malloc(rows * sizeof(int)); // Rows left behind for the next one
+    if (!open || !pending || !queued || !span || !queue || !next_queue) {
+        printf("Error: Cannot allocate flood state.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (long long w = 0; w < (long long)rows * words; w++) {
+        open[w] = ~walls->words[w];
+    }
+    STATS_ADD(counters, state_bytes, (long long)rows * (words * sizeof(uint64_t) + 2 + 4 * sizeof(int)));
+    STATS_PHASE(counters, "search");
+
+    // The start's own run first; from then on every row is closed and only rows next to a
+    // changed row can gain anything
+    int row = start / walls->stride;
+    int goal_row = goal >= 0 ? goal / walls->stride : -1;
+    int word = (start % walls->stride) / 64, first, last;
+    maze_bit_set(reached, start);
+    fill_row(reached->words + (size_t)row * words, open + (size_t)row * words, word, word, words, &first, &last);
+    local.row_fills++;
+    int found = goal >= 0 && maze_bit_test(reached, goal);
+    int count = 0;
+    for (int r = row + 1; r >= row - 1; r -= 2) {
+        if (r >= 0 && r < rows && mark_pending(pending, span, r, first, last)) {
+            queue[count++] = r;
+        }
+    }
+
+    // Alternate down and up sweeps. A change passes straight on to the next row of the sweep;
+    // the row behind it waits for the next sweep, which runs the other way. Each sweep takes
+    // the rows left behind by the last one in reverse order, i.e. in its own direction.
+    int dir = 1;
+    while (!found && count > 0) {
+        int next_count = 0;
+        local.sweeps++;
+        for (int i = count - 1; i >= 0 && !found; i--) {
+            for (int r = queue[i]; r >= 0 && r < rows && pending[r]; r += dir) {
+                pending[r] = 0;
+                uint64_t* words_r = reached->words + (size_t)r * words;
+                first = span[2 * r];
+                last = span[2 * r + 1];
+                local.row_fills++;
+                STATS_INC(counters, expanded);
+                if (!merge_row(words_r, words_r - words, words_r + words, open + (size_t)r * words, words, &first, &last)) {
+                    break;
+                }
+                if (r == goal_row && maze_bit_test(reached, goal)) {
+                    found = 1;
+                    break;
+                }
+                int ahead = r + dir, behind = r - dir;
+                // A row queued for the next sweep may still be walked into by this one, and then
+                // left behind again
+                if (behind >= 0 && behind < rows && mark_pending(pending, span, behind, first, last) && !queued[behind]) {
+                    queued[behind] = 1;
+                    next_queue[next_count++] = behind;
+                }
+                if (ahead >= 0 && ahead < rows) {
+                    mark_pending(pending, span, ahead, first, last);
+                }
+            }
+        }
+        int* swap = queue;
+        queue = next_queue;
+        next_queue = swap;
+        count = next_count;
+        for (int i = 0; i < count; i++) {
+            queued[queue[i]] = 0;
+        }
+        STATS_MAX(counters, peak_open, count);
+        dir = -dir;
+    }
+
+    STATS_PHASE(counters, "count");
+    if (stats) {
+        local.cells = count_cells(reached);
+        *stats = local;
+    }
+    STATS_ADD(counters, generated, stats ? local.cells : count_cells(reached));
+    STATS_REPORT(counters);
+    free(open);
+    free(pending);
+    free(queued);
+    free(span);
+    free(queue);
+    free(next_queue);
+    return found;
+}
+
+int reach_layers(const struct maze_bitmap* walls, int start, int goal, struct maze_bitmap* reached,
+                 struct reach_stats* stats) {
+    struct reach_stats local = { 0, 0, 0 };
+    if (maze_bit_test(walls, start) || (goal >= 0 && maze_bit_test(walls, goal))) {
+        if (stats) {
+            *stats = local;
+        }
+        return -1;
+    }
+    STATS_DECLARE(counters, "layers");
+
+    int rows = walls->rows, words = walls->words_per_row;
+    struct maze_bitmap frontier, next;
+    maze_bitmap_alloc(&frontier, rows, walls->cols);
+    maze_bitmap_alloc(&next, rows, walls->cols);
+    int* active = (int*)malloc(rows * sizeof(int));     // Rows with frontier cells
+    int* touched = (int*)malloc(rows * sizeof(int));    // Rows the next layer can reach
+    int* stamp = (int*)malloc(rows * sizeof(int));      // Layer a row was last added to touched
+    int* span = (int*)malloc(2 * rows * sizeof(int));   // Words holding an active row's frontier
+    int* reach = (int*)malloc(2 * rows * sizeof(int));  // Words a touched row can gain cells in
+    if (!active || !touched || !stamp || !span || !reach) {
+        printf("Error: Cannot allocate flood state.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int r = 0; r < rows; r++) {
+        stamp[r] = -1;
+    }
+    STATS_ADD(counters, state_bytes, 2 * maze_bitmap_bytes(&frontier) + 7LL * rows * sizeof(int));
+    STATS_PHASE(counters, "search");
+
+    maze_bit_set(reached, start);
+    maze_bit_set(&frontier, start);
+    active[0] = start / walls->stride;
+    span[2 * active[0]] = span[2 * active[0] + 1] = (start % walls->stride) / 64;
+    int count = 1;
+    int layer = 0, distance = start == goal ? 0 : -1;
+    while (distance < 0 && count > 0) {
+        layer++;
+        local.sweeps++;
+        // A frontier word reaches the same words of the rows either side and one word further
+        // left and right
+        int candidates = 0;
+        for (int i = 0; i < count; i++) {
+            int lo = span[2 * active[i]] > 0 ? span[2 * active[i]] - 1 : 0;
+            int hi = span[2 * active[i] + 1] < words - 1 ? span[2 * active[i] + 1] + 1 : words - 1;
+            for (int r = active[i] - 1; r <= active[i] + 1; r++) {
+                if (r < 0 || r >= rows) {
+                    continue;
+                }
+                if (stamp[r] != layer) {
+                    stamp[r] = layer;
+                    touched[candidates++] = r;
+                    reach[2 * r] = lo;
+                    reach[2 * r + 1] = hi;
+                } else {
+                    reach[2 * r] = lo < reach[2 * r] ? lo : reach[2 * r];
+                    reach[2 * r + 1] = hi > reach[2 * r + 1] ? hi : reach[2 * r + 1];
+                }
+            }
+        }
+
+        // One move in every direction at once. A row's last bit is always padding, so the
+        // words either side of a row (or the guard rows) never carry a frontier bit into it.
+        const uint64_t* f = frontier.words;
+        for (int i = 0; i < candidates; i++) {
+            int r = touched[i], first = -1, last = -1;
+            size_t base = (size_t)r * words;
+            for (int k = reach[2 * r]; k <= reach[2 * r + 1]; k++) {
+                size_t w = base + k;
+                uint64_t x = f[w - words] | f[w + words] | (f[w] << 1) | (f[w - 1] >> 63) | (f[w] >> 1) | (f[w + 1] << 63);
+                x &= ~(walls->words[w] | reached->words[w]);
+                next.words[w] = x;
+                reached->words[w] |= x;
+                if (x) {
+                    first = first < 0 ? k : first;
+                    last = k;
+                }
+            }
+            local.row_fills++;
+            STATS_INC(counters, expanded);
+            reach[2 * r] = first;
+            reach[2 * r + 1] = last;
+        }
+
+        // The old frontier is cleared where it was set; the rows that gained cells are the new one
+        for (int i = 0; i < count; i++) {
+            size_t base = (size_t)active[i] * words;
+            for (int k = span[2 * active[i]]; k <= span[2 * active[i] + 1]; k++) {
+                frontier.words[base + k] = 0;
+            }
+        }
+        count = 0;
+        for (int i = 0; i < candidates; i++) {
+            int r = touched[i];
+            if (reach[2 * r] >= 0) {
+                active[count++] = r;
+                span[2 * r] = reach[2 * r];
+                span[2 * r + 1] = reach[2 * r + 1];
+            }
+        }
+        STATS_MAX(counters, peak_open, count);
+        struct maze_bitmap swap = frontier;
+        frontier = next;
+        next = swap;
+        if (goal >= 0 && maze_bit_test(&frontier, goal)) {
+            distance = layer;
+        }
+    }
+
+    STATS_PHASE(counters, "count");
+    if (stats) {
+        local.cells = count_cells(reached);
+        *stats = local;
+    }
+    STATS_ADD(counters, generated, stats ? local.cells : count_cells(reached));
+    STATS_REPORT(counters);
+    maze_bitmap_free(&frontier);
+    maze_bitmap_free(&next);
+    free(active);
+    free(touched);
+    free(stamp);
+    free(span);
+    free(reach);
+    return distance;
+}
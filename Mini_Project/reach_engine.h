@@ -0,0 +1,30 @@
+#ifndef REACH_ENGINE_H
+#define REACH_ENGINE_H
+
+#include "maze_bits.h"
+
+// Work done by one flood
+struct reach_stats {
+    long long sweeps;     // Passes over the rows (reach_flood) or BFS layers (reach_layers)
+    long long row_fills;  // Rows recomputed, a whole row of words each
+    long long cells;      // Cells reached
+};
+
+// Bit-parallel flood fill from start over a sealed wall bitmap, 64 cells per operation. A row
+// grows along its open runs with one add (towards higher columns, the carry runs to the end of
+// each run) and a shift/and fill (towards lower columns), then passes what it reached to the
+// rows above and below with an and. Sweeps go down and up the rows, visiting only rows next to
+// one that changed, until nothing changes or the goal is reached. Every reached cell is set in
+// reached (allocated like walls and clear); with goal -1 that is the start's whole component.
+// Returns 1 if the goal was reached, 0 otherwise.
+int reach_flood(const struct maze_bitmap* walls, int start, int goal, struct maze_bitmap* reached,
+                struct reach_stats* stats);
+
+// Level-synchronous version: every step grows the frontier by one move in all four directions
+// at once, so the number of steps taken until the goal is reached is its BFS distance. Slower
+// than reach_flood (one pass per move instead of per turn of the path), but still touches only
+// the rows the frontier is on. Returns the distance in moves, or -1 if the goal is unreachable.
+int reach_layers(const struct maze_bitmap* walls, int start, int goal, struct maze_bitmap* reached,
+                 struct reach_stats* stats);
+
+#endif
@@ -0,0 +1,210 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "maze_core.h"
+#include "maze_bits.h"
+#include "maze_io.h"
+#include "Astar_code.h"
+#include "dstar_engine.h"
+
+// Repair cost of the D* Lite planner against a full A* replan after batches of 1, 100 and
+// 10000 wall changes. Walls are sprinkled on free cells the way maze_generator's obstacle
+// option does; every other round takes the previous round's walls away again, so the map stays
+// near its starting density and both directions of change are measured. After every round the
+// repaired length must equal the A* length on the same map.
+//
+// Usage: replan_bench [size | maze file] [--rounds 20] [--seed 1]
+// Default: a generated 1001 x 1001 open room with 10% walls, start and goal in opposite corners.
+
+#define REPLAN_MAX_ROUNDS 1000
+
+double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+unsigned long long rng_state;
+
+unsigned next_random(void) {
+    rng_state = rng_state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (unsigned)(rng_state >> 33);
+}
+
+// Open room with about 10% of the cells walled, corners left open
+void generate_walls(struct maze_bitmap *walls, int size) {
+    maze_bitmap_alloc(walls, size, size);
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            if (next_random() % 10 == 0) {
+                maze_bit_set(walls, maze_bit_index(walls, i, j));
+            }
+        }
+    }
+    maze_bit_clear(walls, maze_bit_index(walls, 0, 0));
+    maze_bit_clear(walls, maze_bit_index(walls, size - 1, size - 1));
+    maze_bitmap_seal(walls);
+}
+
+int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+double median_ms(double *seconds, int n) {
+    qsort(seconds, n, sizeof(double), compare_doubles);
+    return 1e3 * (n % 2 ? seconds[n / 2] : (seconds[n / 2 - 1] + seconds[n / 2]) / 2);
+}
+
+int main(int argc, char *argv[]) {
+    const char *source = "1001";
+    int rounds = 20;
+    rng_state = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--rounds") == 0 && i + 1 < argc) {
+            rounds = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            rng_state = strtoull(argv[++i], NULL, 10);
+        } else if (argv[i][0] != '-') {
+            source = argv[i];
+        } else {
+            printf("Usage: %s [size | maze file] [--rounds 20] [--seed 1]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (rounds < 2 || rounds > REPLAN_MAX_ROUNDS) {
+        printf("Error: --rounds must be between 2 and %d.\n", REPLAN_MAX_ROUNDS);
+        return 1;
+    }
+
+    // A number is a generated room of that size; anything else is a maze file with 's' and 'g'
+    struct maze_bitmap walls;
+    int start, goal;
+    char *end;
+    long size = strtol(source, &end, 10);
+    if (*end == '\0') {
+        if (size < 2 || size > 20000) {
+            printf("Error: Size %ld is out of range.\n", size);
+            return 1;
+        }
+        generate_walls(&walls, (int)size);
+        start = maze_bit_index(&walls, 0, 0);
+        goal = maze_bit_index(&walls, walls.rows - 1, walls.cols - 1);
+    } else {
+        struct maze_file file;
+        if (maze_file_open(&file, source) < 0) {
+            return 1;
+        }
+        maze_file_to_bitmap(&file, &walls, 'x');
+        if (file.start_row < 0 || file.goal_row < 0) {
+            printf("Error: %s has no start or goal.\n", source);
+            return 1;
+        }
+        start = maze_bit_index(&walls, file.start_row, file.start_col);
+        goal = maze_bit_index(&walls, file.goal_row, file.goal_col);
+        maze_file_close(&file);
+    }
+
+    struct dstar_planner planner;
+    double t0 = now_seconds();
+    int length = dstar_init(&planner, &walls, start, goal);
+    double t1 = now_seconds();
+    printf("%s: %d x %d, initial plan %d moves in %.3f ms (%lld pops)\n", source, walls.rows, walls.cols,
+           length, 1e3 * (t1 - t0), planner.stats.pops);
+
+    // Full replans run on the planner's own map, so both see every change. The map only ever
+    // gains walls over the initial one, so landmarks built on it stay admissible in an ALT build.
+    struct Landmarks landmarks = {0};
+    if (heuristicNeedsLandmarks(heuristicKind)) {
+        buildLandmarks(&landmarks, &walls, ALT_DEFAULT_LANDMARKS);
+        heuristicLandmarks = &landmarks;
+    }
+    struct AStarContext *context = createAStarContext(&planner.walls, openListKind);
+    struct maze_bitmap path, chosen;
+    maze_bitmap_alloc(&path, walls.rows, walls.cols);
+    maze_bitmap_alloc(&chosen, walls.rows, walls.cols);
+
+    // A batch may wall up at most half of the free cells
+    long long free_cells = 0;
+    for (int i = 0; i < walls.rows; i++) {
+        for (int j = 0; j < walls.cols; j++) {
+            free_cells += !maze_bit_test(&walls, maze_bit_index(&walls, i, j));
+        }
+    }
+
+    const int batches[] = { 1, 100, 10000 };
+    double *repair = (double *)malloc(rounds * sizeof(double));
+    double *replan = (double *)malloc(rounds * sizeof(double));
+    struct dstar_change *changes = (struct dstar_change *)malloc(10000 * sizeof(struct dstar_change));
+    if (!repair || !replan || !changes) {
+        printf("Error: Cannot allocate benchmark state.\n");
+        return 1;
+    }
+    printf("%8s %8s %16s %16s %14s %14s %8s\n", "changes", "rounds", "repair ms (med)", "replan ms (med)",
+           "repair pops", "replan pops", "speedup");
+    for (int b = 0; b < (int)(sizeof(batches) / sizeof(batches[0])); b++) {
+        int count = batches[b];
+        if (count > free_cells / 2) {
+            printf("%8d: skipped, the maze has only %lld free cells\n", count, free_cells);
+            continue;
+        }
+        long long repair_pops = 0, replan_pops = 0;
+        int unreachable = 0;
+        for (int r = 0; r < rounds; r++) {
+            if (r % 2 == 0) {
+                // Wall up distinct free cells other than the start and the goal
+                maze_bitmap_clear(&chosen);
+                for (int n = 0; n < count;) {
+                    int cell = maze_bit_index(&walls, next_random() % walls.rows, next_random() % walls.cols);
+                    if (cell != start && cell != goal && !maze_bit_test(&planner.walls, cell) && !maze_bit_test(&chosen, cell)) {
+                        maze_bit_set(&chosen, cell);
+                        changes[n++] = (struct dstar_change){ .cell = cell, .blocked = true };
+                    }
+                }
+            } else {
+                // Take the same walls down again
+                for (int n = 0; n < count; n++) {
+                    changes[n].blocked = false;
+                }
+            }
+
+            long long pops = planner.stats.pops;
+            double s0 = now_seconds();
+            int repaired = dstar_update(&planner, changes, count);
+            double s1 = now_seconds();
+            repair_pops += planner.stats.pops - pops;
+
+            int full = aStarQuery(context, start, goal);
+            double s2 = now_seconds();
+            replan_pops += context->expanded;
+            repair[r] = s1 - s0;
+            replan[r] = s2 - s1;
+
+            maze_bitmap_clear(&path);
+            if (repaired != full || dstar_path(&planner, &path) != repaired) {
+                printf("Error: Round %d of %d changes: repaired length %d, A* length %d.\n", r, count, repaired, full);
+                return 1;
+            }
+            unreachable += repaired < 0;
+        }
+        double repair_ms = median_ms(repair, rounds), replan_ms = median_ms(replan, rounds);
+        printf("%8d %8d %16.3f %16.3f %14lld %14lld %7.1fx", count, rounds, repair_ms, replan_ms,
+               repair_pops / rounds, replan_pops / rounds, repair_ms > 0 ? replan_ms / repair_ms : 0);
+        if (unreachable) {
+            printf("  (goal cut off in %d rounds)", unreachable);
+        }
+        printf("\n");
+    }
+
+    free(repair);
+    free(replan);
+    free(changes);
+    freeAStarContext(context);
+    freeLandmarks(&landmarks);
+    dstar_free(&planner);
+    maze_bitmap_free(&path);
+    maze_bitmap_free(&chosen);
+    maze_bitmap_free(&walls);
+    return 0;
+}
@@ -0,0 +1,92 @@
+#ifndef SEARCH_STATS_H
+#define SEARCH_STATS_H
+
+// Opt-in search instrumentation. Build with -DMAZE_STATS and every search engine counts its
+// work and prints one JSON object per solve on stderr:
+//
+//   {"engine": "astar", "expanded": 123, "generated": 456, "reopened": 7, "peak_open": 89,
+//    "state_bytes": 1048576, "peak_rss_kb": 2048, "phases": {"setup": 0.000012, "search": ...}}
+//
+// expanded counts cells (or graph nodes) taken off the open list, stack or frontier, generated
+// the successors pushed, reopened the successors pushed again with a better cost, peak_open the
+// largest open list/stack/frontier, and state_bytes the memory the engine allocated for the
+// search. STATS_DECLARE defines and starts a local counter set; STATS_BEGIN starts one kept in
+// a struct (such fields go under #ifdef MAZE_STATS). Phases are timed on the monotonic clock,
+// and each STATS_PHASE ends the previous phase.
+// Without MAZE_STATS every macro expands to nothing, so the hot loops are unchanged.
+
+#ifdef MAZE_STATS
+
+#include <stdio.h>
+#include <time.h>
+#include <sys/resource.h>
+
+#define SEARCH_STATS_PHASES 4
+
+struct search_stats {
+    const char *engine;
+    long long expanded, generated, reopened, peak_open, state_bytes;
+    int phases;
+    const char *phase_names[SEARCH_STATS_PHASES];
+    double phase_seconds[SEARCH_STATS_PHASES];
+    double phase_start;
+};
+
+static inline double search_stats_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Close the running phase and start the named one (NULL only closes)
+static inline void search_stats_phase(struct search_stats *stats, const char *name) {
+    double now = search_stats_now();
+    if (stats->phases > 0) {
+        stats->phase_seconds[stats->phases - 1] += now - stats->phase_start;
+    }
+    if (name && stats->phases < SEARCH_STATS_PHASES) {
+        stats->phase_names[stats->phases++] = name;
+    }
+    stats->phase_start = now;
+}
+
+static inline void search_stats_begin(struct search_stats *stats, const char *engine) {
+    *stats = (struct search_stats){ .engine = engine };
+    search_stats_phase(stats, "setup");
+}
+
+static inline void search_stats_report(struct search_stats *stats) {
+    search_stats_phase(stats, NULL);
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    fprintf(stderr, "{\"engine\": \"%s\", \"expanded\": %lld, \"generated\": %lld, \"reopened\": %lld, "
+                    "\"peak_open\": %lld, \"state_bytes\": %lld, \"peak_rss_kb\": %ld, \"phases\": {",
+            stats->engine, stats->expanded, stats->generated, stats->reopened, stats->peak_open,
+            stats->state_bytes, usage.ru_maxrss);
+    for (int i = 0; i < stats->phases; i++) {
+        fprintf(stderr, "%s\"%s\": %.6f", i ? ", " : "", stats->phase_names[i], stats->phase_seconds[i]);
+    }
+    fprintf(stderr, "}}\n");
+}
+
+#define STATS_DECLARE(s, engine) struct search_stats s; search_stats_begin(&(s), engine)
+#define STATS_BEGIN(s, engine)   search_stats_begin(&(s), engine)
+#define STATS_PHASE(s, name)     search_stats_phase(&(s), name)
+#define STATS_ADD(s, field, n)   ((s).field += (n))
+#define STATS_INC(s, field)      ((s).field++)
+#define STATS_MAX(s, field, v)   do { if ((long long)(v) > (s).field) (s).field = (v); } while (0)
+#define STATS_REPORT(s)          search_stats_report(&(s))
+
+#else
+
+#define STATS_DECLARE(s, engine)
+#define STATS_BEGIN(s, engine)   ((void)0)
+#define STATS_PHASE(s, name)     ((void)0)
+#define STATS_ADD(s, field, n)   ((void)0)
+#define STATS_INC(s, field)      ((void)0)
+#define STATS_MAX(s, field, v)   ((void)0)
+#define STATS_REPORT(s)          ((void)0)
+
+#endif
+
+#endif
@@ -1,8 +1,20 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
 #include <time.h>
 #include <sys/time.h>
+#include "maze_core.h"
+#include "maze_bits.h"
+#include "maze_io.h"
+#include "Astar_code.h"
+#include "dfs_engine.h"
+#include "jps_engine.h"
+#include "bidir_engine.h"
+#include "par_bfs.h"
+#include "maze_labels.h"
 
 #define WALL 'x'
 #define PATH ' '
@@ -10,44 +22,17 @@
 #define GOAL 'g'
 
 #define MAX_DIMENSION 100
+#define BATCH_BLOCK 1024 // Batch queries read, solved in parallel and written per round
 
-char** maze;
-int** visited;
+struct maze_grid maze;
+struct maze_bitmap walls;    // One bit per cell: set for 'x'
+struct maze_bitmap visited;  // One bit per cell: set once a search has entered the cell
+struct maze_bitmap crumbs;   // One bit per cell: set for cells on the solution path
 int rows, cols;
-int start_row, start_col, goal_row, goal_col;
-
-// Define the Cell struct for A* search
-struct Cell {
-    int row;
-    int col;
-    int g_cost;  // Cost from the start node
-    int h_cost;  // Heuristic cost to the goal
-    int f_cost;  // Total cost (g_cost + h_cost)
-    struct Cell* parent;  // Pointer to the parent cell in the path
-};
-
-// Declare functions from Astar_code.c
-void aStarSearch(int** grid, int rows, int cols, struct Cell start, struct Cell goal);
-int** readGridFromFile(const char* filename, int* rows, int* cols, struct Cell* start, struct Cell* goal);
-void printGrid(int** grid, int rows, int cols);
-
-// Function to allocate memory for a 2D char array (for the maze)
-char** allocate_char_matrix(int rows, int cols) {
-    char** matrix = (char**)malloc(rows * sizeof(char*));
-    for (int i = 0; i < rows; i++) {
-        matrix[i] = (char*)malloc(cols * sizeof(char));
-    }
-    return matrix;
-}
-
-// Function to allocate memory for a 2D int array (for visited array)
-int** allocate_int_matrix(int rows, int cols) {
-    int** matrix = (int**)malloc(rows * sizeof(int*));
-    for (int i = 0; i < rows; i++) {
-        matrix[i] = (int*)malloc(cols * sizeof(int));
-    }
-    return matrix;
-}
+int start_row, start_col, goal_row = -1, goal_col = -1;
+const char *maze_path = "maze.txt"; // Text or .mzb maze, optionally given on the command line
+struct Landmarks landmarks;  // ALT tables, loaded only for --heuristic alt or an ALT build
+struct maze_labels labels;   // Connected components, loaded only for batch mode
 
 // High-resolution timer function
 double get_time_in_seconds() {
@@ -56,75 +41,41 @@ double get_time_in_seconds() {
     return time.tv_sec + (time.tv_usec / 1e6);
 }
 
-// Function to read the maze from a file
+// Function to read the maze from a file (mapped, then copied row by row into the grid)
 void read_maze(const char* file_name) {
-    FILE* file = fopen(file_name, "r");
-    if (!file) {
-        printf("Error: Cannot open file %s.\n", file_name);
+    struct maze_file file;
+    if (maze_file_open(&file, file_name) < 0) {
         exit(EXIT_FAILURE);
     }
 
-    fscanf(file, "%d,%d\n", &rows, &cols);
-
-    maze = allocate_char_matrix(rows, cols);
-
-    for (int i = 0; i < rows; i++) {
-        for (int j = 0; j < cols; j++) {
-            fscanf(file, "%c", &maze[i][j]);
-            if (maze[i][j] == '\n') {
-                j--;  // Skip newlines
-                continue;
-            }
-            if (maze[i][j] == 's') {
-                start_row = i;
-                start_col = j;
-            }
-            if (maze[i][j] == 'g') {
-                goal_row = i;
-                goal_col = j;
-            }
-        }
-    }
+    rows = file.rows;
+    cols = file.cols;
+    start_row = file.start_row;
+    start_col = file.start_col;
+    goal_row = file.goal_row;
+    goal_col = file.goal_col;
+    maze_file_to_grid(&file, &maze);
 
-    fclose(file);
+    maze_file_close(&file);
 }
 
-// Function to initialize the visited matrix based on the maze
+// Function to initialize the wall, visited and crumb bitmaps based on the maze
 void initialize_visited() {
-    visited = allocate_int_matrix(rows, cols);
-    for (int i = 0; i < rows; i++) {
-        for (int j = 0; j < cols; j++) {
-            if (maze[i][j] == 'x') {
-                visited[i][j] = 1;  // WALL
-            } else if (maze[i][j] == 'g') {
-                visited[i][j] = 2;  // GOAL
-            } else {
-                visited[i][j] = 0;  // Empty space
-            }
-        }
-    }
+    maze_bitmap_from_grid(&walls, &maze, WALL);
+    maze_bitmap_alloc(&visited, rows, cols);
+    maze_bitmap_alloc(&crumbs, rows, cols);
 }
 
-// Function to implement DFS (kept the same)
+// Directions tried by DFS: left, down, right, up
+const int dfs_directions[4][2] = { {0, -1}, {1, 0}, {0, 1}, {-1, 0} };
+
+// Function to implement DFS (iterative, see dfs_engine.c)
 int dfs(int row, int col) {
-    if (row < 0 || row >= rows || col < 0 || col >= cols || visited[row][col] == 1) {
+    if (row < 0 || row >= rows || col < 0 || col >= cols || goal_row < 0) {
         return 0;
     }
-
-    if (visited[row][col] == 2) {
-        return 1;
-    }
-
-    if (visited[row][col] == 0) {
-        visited[row][col] = 1;  // Mark as visited
-
-        if (dfs(row, col - 1) || dfs(row + 1, col) || dfs(row, col + 1) || dfs(row - 1, col)) {
-            visited[row][col] = 3;  // Mark the path
-            return 1;
-        }
-    }
-
-    return 0;
+    return dfs_iterative(&walls, &visited, &crumbs, maze_index(&maze, row, col),
+                         maze_index(&maze, goal_row, goal_col), dfs_directions);
 }
 
 // Function to solve the maze using A* algorithm
@@ -135,62 +86,321 @@ void solve_with_astar() {
     start.col = start_col;
     dest.row = goal_row;
     dest.col = goal_col;
+    if (goal_row < 0) {
+        printf("Path not found!\n");
+        return;
+    }
 
-    // Read the maze from file and create the grid
-    int **grid = readGridFromFile("maze.txt", &rows, &cols, &start, &dest);
-
-    // Display the input grid
+    // The wall bitmap built by initialize_visited is the A* grid; the file is not read again
     printf("Input Grid:\n");
-    printGrid(grid, rows, cols);
+    printGrid(&walls);
 
     // Perform A* search
-    aStarSearch(grid, rows, cols, start, dest);
+    aStarSearch(&walls, start, dest);
+}
 
-    // Free the dynamically allocated memory for the grid
-    for (int i = 0; i < rows; i++) {
-        free(grid[i]);
+// Function to solve the maze using Jump Point Search; the path goes into crumbs like DFS
+int solve_with_jps() {
+    if (goal_row < 0) {
+        return 0;
+    }
+    struct jps_stats stats;
+    int length = jps_search(&walls, maze_bit_index(&walls, start_row, start_col),
+                            maze_bit_index(&walls, goal_row, goal_col), &crumbs, openListKind, &stats);
+    printf("Open-list operations: %lld pushes, %lld pops (%lld cells scanned)\n",
+           stats.pushes, stats.pops, stats.scanned);
+    if (length < 0) {
+        return 0;
     }
-    free(grid);
+    printf("Path length: %d moves\n", length);
+    return 1;
 }
 
-// Function to write the maze to a file (similar to what was in generate_maze.c)
-void write_maze(const char *filename) {
-    FILE *file = fopen(filename, "w");
-    if (!file) {
-        printf("Error: Cannot write to file %s.\n", filename);
+// Function to solve the maze with a forward and a backward BFS on two threads
+int solve_with_bidir() {
+    if (goal_row < 0) {
+        return 0;
+    }
+    int length = bidir_bfs(&walls, maze_bit_index(&walls, start_row, start_col),
+                           maze_bit_index(&walls, goal_row, goal_col), &crumbs);
+    if (length < 0) {
+        return 0;
+    }
+    printf("Path length: %d moves\n", length);
+    return 1;
+}
+
+// Function to solve the maze with the level-synchronous parallel BFS; the path comes from the parent map
+int solve_with_parallel_bfs(int threads) {
+    if (goal_row < 0) {
+        return 0;
+    }
+    int numCells = rows * walls.stride;
+    int *dist = (int *)malloc(numCells * sizeof(int));
+    atomic_int *parent = (atomic_int *)malloc(numCells * sizeof(atomic_int));
+    if (!dist || !parent) {
+        printf("Error: Cannot allocate BFS state.\n");
         exit(EXIT_FAILURE);
     }
+    int start = maze_bit_index(&walls, start_row, start_col);
+    int goal = maze_bit_index(&walls, goal_row, goal_col);
+    long long reached = par_bfs(&walls, start, threads, dist, parent);
+    printf("Cells reached: %lld\n", reached);
+
+    int found = dist[goal] >= 0;
+    if (found) {
+        printf("Path length: %d moves\n", dist[goal]);
+        for (int cell = goal; cell != start; ) {
+            cell = atomic_load(&parent[cell]);
+            maze_bit_set(&crumbs, cell);
+        }
+    }
+    free(dist);
+    free(parent);
+    return found;
+}
+
+// One (start, goal) query of a batch and its answer
+struct BatchQuery {
+    int start_row, start_col, goal_row, goal_col;
+    int length;    // Moves on the shortest path, -1 if there is none (or the query is invalid)
+    char *moves;   // Path as 'U'/'D'/'L'/'R' when paths are requested, else NULL
+};
+
+// A round of batch queries shared by the worker threads
+struct BatchRound {
+    struct BatchQuery *queries;
+    int count;
+    atomic_int next;
+    atomic_int cut_off;  // Queries answered from the label map alone
+    int with_paths;
+};
+
+struct BatchWorker {
+    struct BatchRound *round;
+    struct AStarContext *context; // Allocated once per thread and reused for every query
+};
 
-    fprintf(file, "%d,%d\n", rows, cols);
-    for (int i = 0; i < rows; i++) {
-        for (int j = 0; j < cols; j++) {
-            fprintf(file, "%c", maze[i][j]);
+// Worker thread: take queries from the round until none are left
+void *batch_worker(void *arg) {
+    struct BatchWorker *worker = (struct BatchWorker *)arg;
+    struct BatchRound *round = worker->round;
+    for (int i = atomic_fetch_add(&round->next, 1); i < round->count; i = atomic_fetch_add(&round->next, 1)) {
+        struct BatchQuery *q = &round->queries[i];
+        q->length = -1;
+        q->moves = NULL;
+        if (q->start_row < 0 || q->start_row >= rows || q->start_col < 0 || q->start_col >= cols ||
+            q->goal_row < 0 || q->goal_row >= rows || q->goal_col < 0 || q->goal_col >= cols) {
+            continue;
+        }
+        int start = maze_bit_index(&walls, q->start_row, q->start_col);
+        int goal = maze_bit_index(&walls, q->goal_row, q->goal_col);
+        if (!maze_labels_connected(&labels, start, goal)) {
+            atomic_fetch_add(&round->cut_off, 1);
+            continue;
+        }
+        q->length = aStarQuery(worker->context, start, goal);
+        if (q->length >= 0 && round->with_paths) {
+            q->moves = (char *)malloc(q->length + 1);
+            if (!q->moves) {
+                printf("Error: Cannot allocate a batch path.\n");
+                exit(EXIT_FAILURE);
+            }
+            aStarPathMoves(worker->context, start, goal, q->moves);
         }
-        fprintf(file, "\n");
     }
+    return NULL;
+}
 
-    fclose(file);
+// Function to answer every "start_row start_col goal_row goal_col" line of queries_path on the
+// loaded maze. Queries are solved by threads in rounds and written in input order as
+// "start_row start_col goal_row goal_col length [moves]"; blank lines and '#' lines are skipped.
+int run_batch(const char *queries_path, const char *out_path, int threads, int with_paths) {
+    FILE *in = fopen(queries_path, "r");
+    if (!in) {
+        printf("Error: Cannot open %s.\n", queries_path);
+        return -1;
+    }
+    FILE *out = out_path ? fopen(out_path, "w") : stdout;
+    if (!out) {
+        printf("Error: Cannot create %s.\n", out_path);
+        fclose(in);
+        return -1;
+    }
+    setvbuf(out, NULL, _IOFBF, 1 << 20);
+
+    struct BatchRound round;
+    round.queries = (struct BatchQuery *)malloc(BATCH_BLOCK * sizeof(struct BatchQuery));
+    round.with_paths = with_paths;
+    atomic_init(&round.cut_off, 0);
+    struct BatchWorker *workers = (struct BatchWorker *)malloc(threads * sizeof(struct BatchWorker));
+    pthread_t *ids = (pthread_t *)malloc(threads * sizeof(pthread_t));
+    if (!round.queries || !workers || !ids) {
+        printf("Error: Cannot allocate batch state.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int t = 0; t < threads; t++) {
+        workers[t].round = &round;
+        workers[t].context = createAStarContext(&walls, openListKind);
+    }
+
+    double begin = get_time_in_seconds();
+    long long answered = 0, found = 0, lineNumber = 0;
+    char line[256];
+    bool more = true;
+    while (more) {
+        // Read one round of queries
+        round.count = 0;
+        while (round.count < BATCH_BLOCK && (more = fgets(line, sizeof(line), in) != NULL)) {
+            lineNumber++;
+            for (char *c = line; *c; c++) {
+                if (*c == ',') {
+                    *c = ' ';
+                }
+            }
+            struct BatchQuery *q = &round.queries[round.count];
+            char first;
+            if (sscanf(line, " %c", &first) != 1 || first == '#') {
+                continue;
+            }
+            if (sscanf(line, "%d %d %d %d", &q->start_row, &q->start_col, &q->goal_row, &q->goal_col) != 4) {
+                printf("Error: %s line %lld is not \"start_row start_col goal_row goal_col\".\n", queries_path, lineNumber);
+                exit(EXIT_FAILURE);
+            }
+            round.count++;
+        }
+        if (round.count == 0) {
+            break;
+        }
+
+        // Solve it on the pool; the calling thread is worker 0
+        atomic_store(&round.next, 0);
+        for (int t = 1; t < threads; t++) {
+            if (pthread_create(&ids[t], NULL, batch_worker, &workers[t]) != 0) {
+                printf("Error: Cannot start batch thread %d.\n", t);
+                exit(EXIT_FAILURE);
+            }
+        }
+        batch_worker(&workers[0]);
+        for (int t = 1; t < threads; t++) {
+            pthread_join(ids[t], NULL);
+        }
+
+        // Write the answers in input order
+        for (int i = 0; i < round.count; i++) {
+            struct BatchQuery *q = &round.queries[i];
+            fprintf(out, "%d %d %d %d %d", q->start_row, q->start_col, q->goal_row, q->goal_col, q->length);
+            if (q->moves) {
+                fputc(' ', out);
+                fputs(q->moves, out);
+                free(q->moves);
+            }
+            fputc('\n', out);
+            found += q->length >= 0;
+        }
+        answered += round.count;
+    }
+    double seconds = get_time_in_seconds() - begin;
+
+    fflush(out);
+    if (out != stdout) {
+        fclose(out);
+    }
+    fclose(in);
+    fprintf(stderr, "Answered %lld queries (%lld with a path, %d cut off by the label map) in %.3f s on %d thread(s): %.0f queries/s\n",
+            answered, found, atomic_load(&round.cut_off), seconds, threads, answered / (seconds > 0 ? seconds : 1e-9));
+
+    for (int t = 0; t < threads; t++) {
+        freeAStarContext(workers[t].context);
+    }
+    free(workers);
+    free(ids);
+    free(round.queries);
+    return 0;
+}
+
+// Function to write the maze to a file (similar to what was in generate_maze.c)
+void write_maze(const char *filename) {
+    if (maze_write_grid(&maze, filename, 1) < 0) {
+        exit(EXIT_FAILURE);
+    }
 }
 
 // Function to mark the path in the maze (for both DFS and A* solution)
 void mark_path_in_maze() {
-    for (int i = 0; i < rows; i++) {
-        for (int j = 0; j < cols; j++) {
-            if (visited[i][j] == 3) {  // Mark the path
-                maze[i][j] = '.';
-            }
+    int n = rows * maze.stride;
+    for (int i = 0; i < n; i++) {
+        if (maze_bit_test(&crumbs, i)) {  // Mark the path
+            maze.cells[i] = '.';
         }
     }
 }
 
 // Function to ask the user which algorithm to use and solve the maze
-int main() {
-    // Read the maze from file
-    read_maze("maze.txt");
+int main(int argc, char *argv[]) {
+    // Command line: [maze file] [--batch queries] [--threads N] [--paths] [--out file] [--list heap|bucket] [--heuristic manhattan|zero|alt] [--landmarks K]
+    const char *batch_path = NULL, *out_path = NULL;
+    int threads = 1, with_paths = 0, landmark_count = ALT_DEFAULT_LANDMARKS;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+            batch_path = argv[++i];
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            out_path = argv[++i];
+        } else if (strcmp(argv[i], "--list") == 0 && i + 1 < argc && parseOpenListKind(argv[i + 1], &openListKind)) {
+            i++;
+        } else if (strcmp(argv[i], "--heuristic") == 0 && i + 1 < argc && parseHeuristicKind(argv[i + 1], &heuristicKind)) {
+            i++;
+        } else if (strcmp(argv[i], "--landmarks") == 0 && i + 1 < argc) {
+            landmark_count = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--paths") == 0) {
+            with_paths = 1;
+        } else if (argv[i][0] != '-') {
+            maze_path = argv[i];
+        } else {
+            printf("Usage: %s [maze file] [--batch queries] [--threads N] [--paths] [--out file] [--list heap|bucket] [--heuristic manhattan|zero|alt] [--landmarks K]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (threads < 1) {
+        threads = 1;
+    }
+    if (landmark_count < 1 || landmark_count > ALT_MAX_LANDMARKS) {
+        printf("Error: --landmarks must be between 1 and %d.\n", ALT_MAX_LANDMARKS);
+        return 1;
+    }
+
+    // Read the maze from file (text or .mzb)
+    read_maze(maze_path);
 
     // Initialize the visited matrix
     initialize_visited();
 
+    // ALT landmark tables are cached next to the maze and rebuilt when it changes
+    if (heuristicNeedsLandmarks(heuristicKind)) {
+        if (prepareLandmarks(&landmarks, maze_path, &walls, landmark_count) < 0) {
+            exit(EXIT_FAILURE);
+        }
+        heuristicLandmarks = &landmarks;
+    }
+
+    // Batch mode: answer a whole file of queries on the loaded maze, then exit. Queries between
+    // components are answered from the label map, cached next to the maze like the landmarks.
+    if (batch_path) {
+        if (maze_labels_prepare(&labels, maze_path, &walls, threads) < 0) {
+            exit(EXIT_FAILURE);
+        }
+        int status = run_batch(batch_path, out_path, threads, with_paths);
+        maze_labels_free(&labels);
+        maze_grid_free(&maze);
+        maze_bitmap_free(&walls);
+        maze_bitmap_free(&visited);
+        maze_bitmap_free(&crumbs);
+        freeLandmarks(&landmarks);
+        return status < 0 ? 1 : 0;
+    }
+
     // Ask the user which algorithm to use
     int choice;
     double start_time, end_time, time_taken;
@@ -198,6 +408,9 @@ int main() {
     printf("Choose the algorithm to solve the maze:\n");
     printf("1. Depth-First Search (DFS)\n");
     printf("2. A* Search\n");
+    printf("3. Jump Point Search (JPS)\n");
+    printf("4. Bidirectional BFS (two threads)\n");
+    printf("5. Parallel BFS (thread pool)\n");
     printf("Enter choice: ");
     scanf("%d", &choice);
 
@@ -214,12 +427,62 @@ int main() {
         time_taken = end_time - start_time;
         printf("Time taken by DFS: %.6f seconds\n", time_taken);
     } else if (choice == 2) {
+        int listChoice;
+        printf("Choose the A* open list:\n");
+        printf("1. Binary heap\n");
+        printf("2. Bucket queue\n");
+        printf("Enter choice: ");
+        scanf("%d", &listChoice);
+        openListKind = (listChoice == 2) ? OPEN_LIST_BUCKET : OPEN_LIST_HEAP;
+
         start_time = get_time_in_seconds();
         // Solve using A* algorithm
         solve_with_astar();
         end_time = get_time_in_seconds();
         time_taken = end_time - start_time;
         printf("Time taken by A*: %.6f seconds\n", time_taken);
+    } else if (choice == 3) {
+        start_time = get_time_in_seconds();
+        // Jump between straight-line jump points instead of expanding every cell
+        if (!solve_with_jps()) {
+            printf("No path to the goal could be found using JPS.\n");
+        } else {
+            mark_path_in_maze();
+            printf("JPS Path found and maze solved.\n");
+        }
+        end_time = get_time_in_seconds();
+        time_taken = end_time - start_time;
+        printf("Time taken by JPS: %.6f seconds\n", time_taken);
+    } else if (choice == 4) {
+        start_time = get_time_in_seconds();
+        // Search from both ends at once until the fronts meet
+        if (!solve_with_bidir()) {
+            printf("No path to the goal could be found using bidirectional BFS.\n");
+        } else {
+            mark_path_in_maze();
+            printf("Bidirectional BFS Path found and maze solved.\n");
+        }
+        end_time = get_time_in_seconds();
+        time_taken = end_time - start_time;
+        printf("Time taken by bidirectional BFS: %.6f seconds\n", time_taken);
+    } else if (choice == 5) {
+        int threads = 1;
+        printf("Enter the number of threads: ");
+        if (scanf("%d", &threads) != 1 || threads < 1) {
+            threads = 1;
+        }
+
+        start_time = get_time_in_seconds();
+        // Expand each BFS level across the pool
+        if (!solve_with_parallel_bfs(threads)) {
+            printf("No path to the goal could be found using parallel BFS.\n");
+        } else {
+            mark_path_in_maze();
+            printf("Parallel BFS Path found and maze solved.\n");
+        }
+        end_time = get_time_in_seconds();
+        time_taken = end_time - start_time;
+        printf("Time taken by parallel BFS: %.6f seconds\n", time_taken);
     } else {
         printf("Invalid choice!\n");
     }
@@ -228,12 +491,11 @@ int main() {
     write_maze("sol.txt");
 
     // Free allocated memory
-    for (int i = 0; i < rows; i++) {
-        free(maze[i]);
-        free(visited[i]);
-    }
-    free(maze);
-    free(visited);
+    maze_grid_free(&maze);
+    maze_bitmap_free(&walls);
+    maze_bitmap_free(&visited);
+    maze_bitmap_free(&crumbs);
+    freeLandmarks(&landmarks);
 
     return 0;
 }
@@ -1,182 +1,122 @@
 #include <stdio.h>
 #include <stdlib.h>
-
-char** maze;
-int** visited;
+#include <string.h>
+#include "maze_core.h"
+#include "maze_bits.h"
+#include "maze_io.h"
+#include "dfs_engine.h"
+#include "reach_engine.h"
+
+struct maze_file maze;
+struct maze_bitmap walls;
+struct maze_bitmap visited;
+struct maze_bitmap crumbs;
 int rows;
 int cols;
 int start_row;
 int start_col;
-
-enum terrain {
-	empty,
-	wall,
-	goal,
-	crumb
-};
-
-void alloc_maze()
-{
-	maze = malloc(rows * sizeof(char*));
-	
-	int i;
-	for (i = 0; i < rows; ++i){
-		maze[i] = malloc(cols * sizeof(char*));
-	}
-}
+int goal_row = -1;
+int goal_col = -1;
 
 void alloc_visited()
 {
-	visited = malloc(rows * sizeof(int*));
-	int i;
-	for (i = 0; i < rows; ++i){
-		visited[i] = malloc(cols * sizeof(int*));
-	}
+	maze_bitmap_alloc(&visited, rows, cols);
+	maze_bitmap_alloc(&crumbs, rows, cols);
 }
 
+// Map the maze file; its rows are read in place, never copied
 void get_maze(char* file_name)
 {
-	char c;
-	char rows_s[3] = { '\0' };
-	char cols_s[3] = { '\0' };
-	int rows_i = 0;
-	int cols_i = 0;
-	int swap = 0;
-
-	FILE* maze_file = fopen(file_name, "r");
-
-	if (maze_file) {
-		while ((c = getc(maze_file)) != EOF) {
-			if (c == '\n') {
-				break;
-			} else if (c == ','){
-				swap = 1;
-			} else if (!swap) {
-				rows_s[rows_i] = c;
-				rows_i++;
-			} else {
-				cols_s[cols_i] = c;
-				cols_i++;
-			}
-		}
-	} else {
-		printf("No such file!");
-		return;
+	if (maze_file_open(&maze, file_name) < 0) {
+		exit(EXIT_FAILURE);
 	}
 
-	rows = atoi(rows_s);
-	cols = atoi(cols_s);
-
-	alloc_maze();
-	
-	int i,j;
-
-	for (i = 0; i < rows; ++i) {
-		for (j = 0; j < cols; ++j) {
-
-			if ((c = getc(maze_file)) == '\n') {
-				c = getc(maze_file);
-			}
-
-			maze[i][j] = c;
-
-			if (c =='s') {
-				start_row = i;
-				start_col = j;
-			}
-		}
-	}
-
-	fclose(maze_file);
+	rows = maze.rows;
+	cols = maze.cols;
+	start_row = maze.start_row;
+	start_col = maze.start_col;
+	goal_row = maze.goal_row;
+	goal_col = maze.goal_col;
 }
 
+// One bit per cell: walls from the maze, plus empty visited and crumb bitmaps
 void init_visited()
 {
+	maze_file_to_bitmap(&maze, &walls, 'x');
 	alloc_visited();
+}
 
-	int i, j;
-	for (i = 0; i < rows; ++i) {
-		for (j = 0; j < cols; ++j) {
-			if (maze[i][j] == 'x') {
-				visited[i][j] = wall;
-			} else if (maze[i][j] == 'g') {
-				visited[i][j] = goal;
-			} else {
-				visited[i][j] = empty;
-			}
-		}
-	}
-}	
+// Write the maze with a '.' on every crumb except the start
 void print_maze(char* filename) {
-    FILE* file = fopen(filename, "w"); 
-    if (file == NULL) {
-        printf("Error opening file.\n");
-        return;
-    }
-
-    for (int i = 0; i < rows; i++) {
-        for (int j = 0; j < cols; j++) {
-            fprintf(file, "%c", maze[i][j]);
-        }
-        fprintf(file, "\n");
-    }
-
-    fclose(file);
+	maze_write_marked(&maze, &crumbs, filename);
 }
 
+// Directions tried by dfs: left, down, right, up
+const int dfs_directions[4][2] = { {0, -1}, {1, 0}, {0, 1}, {-1, 0} };
 
-void add_crumbs()
+int dfs(int row, int col)
 {
-	int i, j;
-	for (i = 0; i < rows; ++i) {
-		for (j = 0; j < cols; ++j) {
-			if (maze[i][j] != 's' && visited[i][j] == crumb) {
-				maze[i][j] = '.';
-			}
-		}
+	if (row < 0 || goal_row < 0) {
+		return 0;
 	}
+	return dfs_iterative(&walls, &visited, &crumbs, maze_bit_index(&walls, row, col),
+	                     maze_bit_index(&walls, goal_row, goal_col), dfs_directions);
 }
 
-int dfs(int row, int col)
+// --reachable: answer only whether the goal can be reached, with the bit-parallel flood fill
+// instead of a DFS; --layers also gives the path length. The exit status is 0 if the goal is
+// reachable and 1 if not, so scripts can check a maze before solving it.
+int reachable_only(int layers)
 {
-	int* current = &visited[row][col];
-
-	if (*current == goal) {
+	if (start_row < 0 || goal_row < 0) {
+		printf("No path to the goal could be found.\n");
 		return 1;
 	}
-
-	if (*current == empty) {
-		*current = wall;
-
-		if (dfs(row, col - 1)){
-			*current = crumb;
-			return 1;
-		} 
-		if (dfs(row + 1, col)){
-			*current = crumb;
-			return 1;
-		} 
-		if (dfs(row, col + 1)){
-			*current = crumb;
-			return 1;		
-		} 
-		if (dfs(row - 1, col)){
-			*current = crumb;
-			return 1;
-		}
+	int start = maze_bit_index(&walls, start_row, start_col);
+	int goal = maze_bit_index(&walls, goal_row, goal_col);
+	int length = layers ? reach_layers(&walls, start, goal, &visited, NULL)
+	                    : reach_flood(&walls, start, goal, &visited, NULL) ? 0 : -1;
+	if (length < 0) {
+		printf("No path to the goal could be found.\n");
+		return 1;
+	}
+	if (layers) {
+		printf("The goal is reachable in %d moves.\n", length);
+	} else {
+		printf("The goal is reachable.\n");
 	}
-
 	return 0;
 }
 
-int main() {
-	get_maze("maze.txt");
+int main(int argc, char* argv[]) {
+	// Command line: [maze file] [--reachable] [--layers]; text or .mzb maze, "maze.txt" by default
+	char* file_name = "maze.txt";
+	int reachable = 0, layers = 0;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--reachable") == 0) {
+			reachable = 1;
+		} else if (strcmp(argv[i], "--layers") == 0) {
+			reachable = layers = 1;
+		} else if (argv[i][0] != '-') {
+			file_name = argv[i];
+		} else {
+			printf("Usage: %s [maze file] [--reachable] [--layers]\n", argv[0]);
+			return 1;
+		}
+	}
+	get_maze(file_name);
 	init_visited();
-	if (!dfs(start_row, start_col)) {
+	int status = 0;
+	if (reachable) {
+		status = reachable_only(layers);
+	} else if (!dfs(start_row, start_col)) {
 		printf("No path to the goal could be found.\n");
 	} else {
-		add_crumbs();
 		print_maze("sol.txt");
 	}
-	return 0;
+	maze_file_close(&maze);
+	maze_bitmap_free(&walls);
+	maze_bitmap_free(&visited);
+	maze_bitmap_free(&crumbs);
+	return status;
 }